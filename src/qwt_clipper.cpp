@@ -71,6 +71,203 @@ private:
     double toAngle(const QwtDoublePoint &, const QwtDoublePoint &) const;
 };
 
+/*
+  Clipping of open polylines in a single pass: segments with both
+  ends inside are accepted, segments with both ends on the same
+  outer side are rejected by their outcodes. Only the remaining
+  segments are clipped ( Liang-Barsky ).
+ */
+template <class Polygon, class Point>
+class QwtPolylineClipper
+{
+public:
+    QwtPolylineClipper(double xMin, double xMax, double yMin, double yMax):
+        d_xMin(xMin),
+        d_xMax(xMax),
+        d_yMin(yMin),
+        d_yMax(yMax)
+    {
+    }
+
+    void clipPolyline(const Polygon &polyline,
+        Polygon &clipped, QwtArray<int> &runLengths) const
+    {
+        const int numPoints = polyline.size();
+
+        // resizing to 0 keeps the capacity of the buffers
+        clipped.resize(numPoints);
+        runLengths.resize(0);
+
+        if ( numPoints == 0 )
+            return;
+
+        const Point *points = polyline.data();
+        Point *out = clipped.data();
+
+        int numOut = 0;
+        int runStart = -1;
+
+        Point p1 = points[0];
+        int code1 = outCode(p1);
+
+        if ( code1 == 0 )
+        {
+            runStart = numOut;
+            out[numOut++] = p1;
+        }
+
+        for ( int i = 1; i < numPoints; i++ )
+        {
+            const Point p2 = points[i];
+            const int code2 = outCode(p2);
+
+            if ( ( code1 | code2 ) == 0 )
+            {
+                out[numOut++] = p2;
+            }
+            else if ( ( code1 & code2 ) == 0 )
+            {
+                double t1 = 0.0;
+                double t2 = 1.0;
+
+                if ( clipSegment(p1, p2, t1, t2) )
+                {
+                    if ( code1 != 0 )
+                    {
+                        closeRun(runStart, numOut, runLengths);
+
+                        /*
+                          Entering the rectangle adds 2 points for
+                          a segment. Otherwise it is at most one
+                          point per segment.
+                         */
+                        const int needed = numOut + 2 + numPoints - 1 - i;
+                        if ( needed > clipped.size() )
+                        {
+                            clipped.resize(qwtMax(needed, 2 * clipped.size()));
+                            out = clipped.data();
+                        }
+
+                        runStart = numOut;
+                        out[numOut++] = interpolated(p1, p2, t1);
+                    }
+
+                    out[numOut++] = ( code2 == 0 ) ? p2
+                        : interpolated(p1, p2, t2);
+                }
+
+                if ( code2 != 0 )
+                    closeRun(runStart, numOut, runLengths);
+            }
+
+            p1 = p2;
+            code1 = code2;
+        }
+
+        closeRun(runStart, numOut, runLengths);
+        clipped.resize(numOut);
+    }
+
+private:
+    enum
+    {
+        LeftCode = 1,
+        RightCode = 2,
+        TopCode = 4,
+        BottomCode = 8
+    };
+
+    inline int outCode(const Point &p) const
+    {
+        int code = 0;
+
+        if ( p.x() < d_xMin )
+            code |= LeftCode;
+        else if ( p.x() > d_xMax )
+            code |= RightCode;
+
+        if ( p.y() < d_yMin )
+            code |= TopCode;
+        else if ( p.y() > d_yMax )
+            code |= BottomCode;
+
+        return code;
+    }
+
+    static inline bool clipT(double p, double q, double &t1, double &t2)
+    {
+        if ( p == 0.0 )
+            return q >= 0.0;
+
+        const double r = q / p;
+        if ( p < 0.0 )
+        {
+            if ( r > t2 )
+                return false;
+            if ( r > t1 )
+                t1 = r;
+        }
+        else
+        {
+            if ( r < t1 )
+                return false;
+            if ( r < t2 )
+                t2 = r;
+        }
+
+        return true;
+    }
+
+    bool clipSegment(const Point &p1, const Point &p2,
+        double &t1, double &t2) const
+    {
+        const double dx = p2.x() - p1.x();
+        const double dy = p2.y() - p1.y();
+
+        return clipT(-dx, p1.x() - d_xMin, t1, t2)
+            && clipT(dx, d_xMax - p1.x(), t1, t2)
+            && clipT(-dy, p1.y() - d_yMin, t1, t2)
+            && clipT(dy, d_yMax - p1.y(), t1, t2);
+    }
+
+    static inline Point interpolated(const Point &p1, const Point &p2,
+        double t);
+
+    static inline void closeRun(int &runStart, int numOut,
+        QwtArray<int> &runLengths)
+    {
+        if ( runStart >= 0 )
+        {
+            if ( numOut - runStart > 0 )
+                runLengths += numOut - runStart;
+
+            runStart = -1;
+        }
+    }
+
+    const double d_xMin;
+    const double d_xMax;
+    const double d_yMin;
+    const double d_yMax;
+};
+
+template <>
+inline QPoint QwtPolylineClipper<QwtPolygon, QPoint>::interpolated(
+    const QPoint &p1, const QPoint &p2, double t)
+{
+    return QPoint(qRound(p1.x() + t * ( p2.x() - p1.x() )),
+        qRound(p1.y() + t * ( p2.y() - p1.y() )));
+}
+
+template <>
+inline QwtDoublePoint
+QwtPolylineClipper<QwtPolygonF, QwtDoublePoint>::interpolated(
+    const QwtDoublePoint &p1, const QwtDoublePoint &p2, double t)
+{
+    return QwtDoublePoint(p1.x() + t * ( p2.x() - p1.x() ),
+        p1.y() + t * ( p2.y() - p1.y() ));
+}
+
 QwtPolygonClipper::QwtPolygonClipper(const QRect &r): 
     QRect(r) 
 {
@@ -468,6 +665,58 @@ QwtPolygonF QwtClipper::clipPolygonF(
     return clipper.clipPolygon(polygon);
 }
 
+/*!
+   Clipping of an open polyline
+
+   In opposite to clipPolygon() the polyline is not closed and the
+   parts outside of the clip rectangle are dropped, instead of being
+   replaced by lines along its border. So the result might consist
+   of several disjoint runs of points, that are stored one after
+   the other in clipped.
+
+   The polyline is processed in a single pass. As the output buffers
+   are only resized, they can be reused to avoid allocations.
+
+   \param clipRect Clip rectangle
+   \param polyline Polyline
+   \param clipped Points of the visible runs
+   \param runLengths Number of points of each run
+
+   \sa QwtPainter::drawPolyline()
+*/
+void QwtClipper::clipPolyline(const QRect &clipRect,
+    const QwtPolygon &polyline, QwtPolygon &clipped,
+    QwtArray<int> &runLengths)
+{
+    const QwtPolylineClipper<QwtPolygon, QPoint> clipper(
+        clipRect.left(), clipRect.right(),
+        clipRect.top(), clipRect.bottom());
+
+    clipper.clipPolyline(polyline, clipped, runLengths);
+}
+
+/*!
+   Clipping of an open polyline
+
+   \param clipRect Clip rectangle
+   \param polyline Polyline
+   \param clipped Points of the visible runs
+   \param runLengths Number of points of each run
+
+   \sa clipPolyline(const QRect &, const QwtPolygon &,
+       QwtPolygon &, QwtArray<int> &)
+*/
+void QwtClipper::clipPolyline(const QwtDoubleRect &clipRect,
+    const QwtPolygonF &polyline, QwtPolygonF &clipped,
+    QwtArray<int> &runLengths)
+{
+    const QwtPolylineClipper<QwtPolygonF, QwtDoublePoint> clipper(
+        clipRect.left(), clipRect.right(),
+        clipRect.top(), clipRect.bottom());
+
+    clipper.clipPolyline(polyline, clipped, runLengths);
+}
+
 /*! 
    Circle clipping
 
@@ -27,6 +27,12 @@ class QWT_EXPORT QwtClipper
 public:
     static QwtPolygon clipPolygon(const QRect &, const QwtPolygon &);
     static QwtPolygonF clipPolygonF(const QwtDoubleRect &, const QwtPolygonF &);
+
+    static void clipPolyline(const QRect &, const QwtPolygon &,
+        QwtPolygon &clipped, QwtArray<int> &runLengths);
+    static void clipPolyline(const QwtDoubleRect &, const QwtPolygonF &,
+        QwtPolygonF &clipped, QwtArray<int> &runLengths);
+
     static QwtArray<QwtDoubleInterval> clipCircle(
         const QwtDoubleRect &, const QwtDoublePoint &, double radius);
 };
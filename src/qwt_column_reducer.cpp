@@ -0,0 +1,68 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_column_reducer.h"
+
+/*!
+  Constructor
+
+  \param points Array, where the reduced points are appended
+*/
+QwtColumnReducer::QwtColumnReducer(QwtArray<QwtDoublePoint> &points):
+    d_points(points),
+    d_count(0),
+    d_column(0.0),
+    d_minValue(0.0),
+    d_maxValue(0.0),
+    d_minIndex(0),
+    d_maxIndex(0)
+{
+}
+
+//! Destructor, flushing the last column
+QwtColumnReducer::~QwtColumnReducer()
+{
+    flush();
+}
+
+/*!
+  Append the reduced points of the current column
+
+  In the order of the points the first, the minimum, the maximum
+  and the last point are appended, where each point is appended
+  only once.
+*/
+void QwtColumnReducer::flush()
+{
+    if ( d_count == 0 )
+        return;
+
+    const int last = d_count - 1;
+
+    int i1 = d_minIndex;
+    int i2 = d_maxIndex;
+    QwtDoublePoint p1 = d_min;
+    QwtDoublePoint p2 = d_max;
+
+    if ( i1 > i2 )
+    {
+        qSwap(i1, i2);
+        qSwap(p1, p2);
+    }
+
+    d_points += d_first;
+    if ( i1 > 0 && i1 < last )
+        d_points += p1;
+    if ( i2 > i1 && i2 < last )
+        d_points += p2;
+    if ( last > 0 )
+        d_points += d_last;
+
+    d_count = 0;
+}
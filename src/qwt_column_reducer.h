@@ -0,0 +1,98 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_COLUMN_REDUCER_H
+#define QWT_COLUMN_REDUCER_H 1
+
+#include "qwt_global.h"
+#include "qwt_array.h"
+#include "qwt_double_rect.h"
+
+/*!
+  \brief Reduction of consecutive points in the same pixel column
+
+  Consecutive points, that are appended for the same column, are
+  reduced to the first, the minimum, the maximum and the last point
+  of the column. Connecting the reduced points results in the same
+  pixels as connecting all points.
+
+  The column of a point and the value, that is aggregated, are
+  passed with the point, so that the points can be in any coordinate
+  system. The reduced points are appended to an array.
+
+  \sa QwtDataPyramid, QwtPlotCurve::PaintDecimated
+*/
+class QWT_EXPORT QwtColumnReducer
+{
+public:
+    explicit QwtColumnReducer(QwtArray<QwtDoublePoint> &points);
+    ~QwtColumnReducer();
+
+    void append(double column, double value, const QwtDoublePoint &);
+    void flush();
+
+private:
+    QwtArray<QwtDoublePoint> &d_points;
+
+    int d_count;
+    double d_column;
+
+    QwtDoublePoint d_first;
+    QwtDoublePoint d_min;
+    QwtDoublePoint d_max;
+    QwtDoublePoint d_last;
+
+    double d_minValue;
+    double d_maxValue;
+    int d_minIndex;
+    int d_maxIndex;
+};
+
+/*!
+  Append a point
+
+  \param column Column of the point, f.e. the floored x coordinate
+                in paint device coordinates
+  \param value Value, that is aggregated, f.e. the y coordinate
+  \param pos Point
+*/
+inline void QwtColumnReducer::append(double column, double value,
+    const QwtDoublePoint &pos)
+{
+    if ( d_count > 0 && column == d_column )
+    {
+        if ( value < d_minValue )
+        {
+            d_min = pos;
+            d_minValue = value;
+            d_minIndex = d_count;
+        }
+        else if ( value > d_maxValue )
+        {
+            d_max = pos;
+            d_maxValue = value;
+            d_maxIndex = d_count;
+        }
+
+        d_last = pos;
+        d_count++;
+    }
+    else
+    {
+        flush();
+
+        d_column = column;
+        d_first = d_min = d_max = d_last = pos;
+        d_minValue = d_maxValue = value;
+        d_minIndex = d_maxIndex = 0;
+        d_count = 1;
+    }
+}
+
+#endif
@@ -15,7 +15,8 @@
 #include <qvector.h>
 
 //! Constructor
-QwtCurveFitter::QwtCurveFitter()
+QwtCurveFitter::QwtCurveFitter():
+    d_revision(0)
 {
 }
 
@@ -24,6 +25,46 @@ QwtCurveFitter::~QwtCurveFitter()
 {
 }
 
+/*!
+  \brief Check if the fitter commutes with linear scale maps
+
+  A fitter is affine invariant for a series of points, when fitting
+  the points, that have been mapped by linear transformations of x and y
+  ( increasing for x ), gives the same result as mapping the fitted points.
+  Then QwtPlotCurve can fit the curve once in scale coordinates and
+  reuse the result, when the scales are changed.
+
+  \param points Series of data points in scale coordinates
+  \return The default implementation returns false.
+  \sa QwtPlotCurve::CacheFitted
+*/
+bool QwtCurveFitter::isAffineInvariant(const QPolygonF &points) const
+{
+    Q_UNUSED(points);
+    return false;
+}
+
+/*!
+  \return Revision of the settings, that is incremented,
+          whenever a setting has been changed
+  \sa invalidate()
+*/
+int QwtCurveFitter::revision() const
+{
+    return d_revision;
+}
+
+/*!
+  Increment the revision. Derived classes have to call invalidate(),
+  when a setting has been changed, that has an effect on fitCurve().
+
+  \sa revision()
+*/
+void QwtCurveFitter::invalidate()
+{
+    d_revision++;
+}
+
 class QwtSplineCurveFitter::PrivateData
 {
 public:
@@ -59,6 +100,7 @@ QwtSplineCurveFitter::~QwtSplineCurveFitter()
 void QwtSplineCurveFitter::setFitMode(FitMode mode)
 {
     d_data->fitMode = mode;
+    invalidate();
 }
 
 /*!
@@ -74,6 +116,8 @@ void QwtSplineCurveFitter::setSpline(const QwtSpline &spline)
 {
     d_data->spline = spline;
     d_data->spline.reset();
+
+    invalidate();
 }
 
 const QwtSpline &QwtSplineCurveFitter::spline() const
@@ -81,6 +125,11 @@ const QwtSpline &QwtSplineCurveFitter::spline() const
     return d_data->spline;
 }
 
+/*!
+  \return Spline
+  \note The type of the spline, that might be modified, is part
+        of the revision()
+*/
 QwtSpline &QwtSplineCurveFitter::spline()
 {
     return d_data->spline;
@@ -89,6 +138,7 @@ QwtSpline &QwtSplineCurveFitter::spline()
 void QwtSplineCurveFitter::setSplineSize(int splineSize)
 {
     d_data->splineSize = qwtMax(splineSize, 10);
+    invalidate();
 }
 
 int QwtSplineCurveFitter::splineSize() const
@@ -130,6 +180,44 @@ QPolygonF QwtSplineCurveFitter::fitCurve(const QPolygonF &points) const
         return fitSpline(points);
 }
 
+/*!
+  \return true, when the points are interpolated by a function of x.
+          This is the case for the Spline mode and for the Auto mode,
+          when the x coordinates of the points are increasing.
+*/
+bool QwtSplineCurveFitter::isAffineInvariant(const QPolygonF &points) const
+{
+    if ( d_data->fitMode == Spline )
+        return true;
+
+    if ( d_data->fitMode == Auto )
+    {
+        const QwtDoublePoint *p = points.data();
+        for ( int i = 1; i < int(points.size()); i++ )
+        {
+            if ( p[i].x() <= p[i-1].x() )
+                return false;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+/*!
+  \return Revision of the settings, including the type of the spline,
+          that might have been changed by spline()
+*/
+int QwtSplineCurveFitter::revision() const
+{
+    int revision = 2 * QwtCurveFitter::revision();
+    if ( d_data->spline.splineType() == QwtSpline::Periodic )
+        revision++;
+
+    return revision;
+}
+
 QPolygonF QwtSplineCurveFitter::fitSpline(
     const QPolygonF &points) const
 {
@@ -275,6 +363,7 @@ QwtWeedingCurveFitter::~QwtWeedingCurveFitter()
 void QwtWeedingCurveFitter::setTolerance(double tolerance)
 {
     d_data->tolerance = qwtMax(tolerance, 0.0);
+    invalidate();
 }
 
 /*!
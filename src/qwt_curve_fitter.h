@@ -33,12 +33,20 @@ public:
      */
     virtual QPolygonF fitCurve(const QPolygonF &polygon) const = 0;
 
+    virtual bool isAffineInvariant(const QPolygonF &points) const;
+
+    virtual int revision() const;
+
 protected:
     QwtCurveFitter();
 
+    void invalidate();
+
 private:
     QwtCurveFitter( const QwtCurveFitter & );
     QwtCurveFitter &operator=( const QwtCurveFitter & );
+
+    int d_revision;
 };
 
 /*!
@@ -68,6 +76,9 @@ public:
     int splineSize() const;
 
     virtual QPolygonF fitCurve(const QPolygonF &) const;
+    virtual bool isAffineInvariant(const QPolygonF &) const;
+
+    virtual int revision() const;
 
 private:
     QPolygonF fitSpline(const QPolygonF &) const;
@@ -10,6 +10,80 @@
 #include "qwt_math.h"
 #include "qwt_data.h"
 
+static const size_t qwtBlockSize = 4096;
+
+// number of values, that are equal to value
+static size_t qwtCountEqual(const double *values, size_t size, double value)
+{
+    size_t count = 0;
+    for ( size_t i = 0; i < size; i++ )
+    {
+        if ( values[i] == value )
+            count++;
+    }
+
+    return count;
+}
+
+/*
+  Extend an interval by a value and update the number of values,
+  that are equal to its bounds
+ */
+static inline void qwtExtendInterval(double &min, double &max,
+    size_t &minCount, size_t &maxCount, double value)
+{
+    if ( value < min )
+    {
+        min = value;
+        minCount = 1;
+    }
+    else if ( value == min )
+    {
+        minCount++;
+    }
+
+    if ( value > max )
+    {
+        max = value;
+        maxCount = 1;
+    }
+    else if ( value == max )
+    {
+        maxCount++;
+    }
+}
+
+/*
+  Remove a value from an interval. Returns false, when the last value
+  equal to a bound has been removed, so that the interval might shrink.
+ */
+static inline bool qwtRemoveFromInterval(double min, double max,
+    size_t &minCount, size_t &maxCount, double value)
+{
+    bool valid = true;
+
+    if ( value == min && --minCount == 0 )
+        valid = false;
+
+    if ( value == max && --maxCount == 0 )
+        valid = false;
+
+    return valid;
+}
+
+static inline void qwtExtendRect(QwtDoubleRect &rect, double x, double y)
+{
+    if ( x < rect.left() )
+        rect.setLeft(x);
+    else if ( x > rect.right() )
+        rect.setRight(x);
+
+    if ( y < rect.top() )
+        rect.setTop(y);
+    else if ( y > rect.bottom() )
+        rect.setBottom(y);
+}
+
 //! Constructor
 QwtData::QwtData()
 {
@@ -34,31 +108,141 @@ QwtData::~QwtData()
 QwtDoubleRect QwtData::boundingRect() const
 {
     const size_t sz = size();
-
-    if ( sz <= 0 )
+    if ( sz == 0 )
         return QwtDoubleRect(1.0, 1.0, -2.0, -2.0); // invalid
 
-    double minX, maxX, minY, maxY;
-    minX = maxX = x(0);
-    minY = maxY = y(0);
+    // data without direct memory access is copied in bounded blocks
 
-    for ( size_t i = 1; i < sz; i++ )
+    double minX = 0.0, maxX = 0.0, minY = 0.0, maxY = 0.0;
+
+    for ( size_t from = 0; from < sz; from += qwtBlockSize )
     {
-        const double xv = x(i);
-        if ( xv < minX )
-            minX = xv;
-        if ( xv > maxX )
-            maxX = xv;
-
-        const double yv = y(i);
-        if ( yv < minY )
-            minY = yv;
-        if ( yv > maxY )
-            maxY = yv;
+        const size_t n = qwtMin(qwtBlockSize, sz - from);
+
+        const QwtDataBlock block(*this, from, n);
+        const QwtDoubleRect r = qwtBoundingRect(block.xData(),
+            block.yData(), n, block.stride());
+
+        if ( from == 0 )
+        {
+            minX = r.left();
+            maxX = r.right();
+            minY = r.top();
+            maxY = r.bottom();
+        }
+        else
+        {
+            minX = qwtMin(minX, r.left());
+            maxX = qwtMax(maxX, r.right());
+            minY = qwtMin(minY, r.top());
+            maxY = qwtMax(maxY, r.bottom());
+        }
     }
+
     return QwtDoubleRect(minX, minY, maxX - minX, maxY - minY);
 }
 
+/*!
+  \brief Direct access to the memory of the data
+
+  Derived classes, that store their points in memory, can overload
+  rawData() to offer access to them without copying. The x value 
+  of point from + i can be found at x[i * stride], the y value
+  at y[i * stride].
+
+  \param from Index of the first point
+  \param x Returns a pointer to the x value of the first point
+  \param y Returns a pointer to the y value of the first point
+  \param stride Returns the distance ( in doubles ) between 2 
+                consecutive values
+
+  \return false, when no direct access is possible.
+          The default implementation always returns false.
+
+  \sa copyData(), QwtDataBlock
+*/
+bool QwtData::rawData(size_t from, const double **x, const double **y,
+    size_t *stride) const
+{
+    Q_UNUSED(from);
+    Q_UNUSED(x);
+    Q_UNUSED(y);
+    Q_UNUSED(stride);
+
+    return false;
+}
+
+/*!
+  \brief Copy a range of points into a buffer
+
+  The default implementation iterates over x() and y(). Derived 
+  classes should overload it, when they can copy more efficiently.
+
+  \param from Index of the first point
+  \param size Number of points to be copied
+  \param x Buffer for at least size x values
+  \param y Buffer for at least size y values
+
+  \sa rawData(), QwtDataBlock
+*/
+void QwtData::copyData(size_t from, size_t size,
+    double *x, double *y) const
+{
+    for ( size_t i = 0; i < size; i++ )
+    {
+        x[i] = this->x(from + i);
+        y[i] = this->y(from + i);
+    }
+}
+
+/*!
+  \brief Number of points, that have ever been appended
+
+  Data classes for streaming data, that can only be modified by
+  appending points and dropping points from the beginning, return
+  the total number of appended points. Then appendCount() - size()
+  is the number of points, that have been dropped, and caches can
+  be updated incrementally ( see QwtPlotCurve::drawAppended() ).
+
+  \return 0, when the data is modified in other ways.
+          The default implementation always returns 0.
+
+  \sa QwtRingBufferData::appendCount()
+*/
+size_t QwtData::appendCount() const
+{
+    return 0;
+}
+
+/*!
+  Constructor
+
+  \param data Data object
+  \param from Index of the first point of the block
+  \param size Number of points of the block
+*/
+QwtDataBlock::QwtDataBlock(const QwtData &data, size_t from, size_t size):
+    d_x(nullptr),
+    d_y(nullptr),
+    d_stride(1),
+    d_size(size)
+{
+    if ( size == 0 )
+        return;
+
+    if ( !data.rawData(from, &d_x, &d_y, &d_stride) )
+    {
+        d_buffer.resize(int(2 * size));
+
+        double *buffer = d_buffer.data();
+        data.copyData(from, size, buffer, buffer + size);
+
+        d_x = buffer;
+        d_y = buffer + size;
+        d_stride = 1;
+    }
+}
+
 /*!
   Constructor
 
@@ -66,7 +250,8 @@ QwtDoubleRect QwtData::boundingRect() const
   \sa QwtPlotCurve::setData()
 */
 QwtPolygonFData::QwtPolygonFData(const QPolygonF &polygon):
-    d_data(polygon)
+    d_data(polygon),
+    d_boundingRectValid(false)
 {
 }
 
@@ -77,6 +262,8 @@ QwtPolygonFData& QwtPolygonFData::operator=(
     if (this != &data)
     {
         d_data = data.d_data;
+        d_boundingRect = data.d_boundingRect;
+        d_boundingRectValid = data.d_boundingRectValid;
     }
     return *this;
 }
@@ -109,6 +296,42 @@ double QwtPolygonFData::y(size_t i) const
     return d_data[int(i)].y(); 
 }
 
+/*!
+  \brief Direct access to the points of the polygon
+
+  The points of a QPolygonF are stored as pairs of x and y values,
+  so the stride is 2.
+
+  \sa QwtData::rawData()
+*/
+bool QwtPolygonFData::rawData(size_t from, const double **x, 
+    const double **y, size_t *stride) const
+{
+    if ( sizeof(qreal) != sizeof(double) )
+        return false;
+
+    const double *values = 
+        reinterpret_cast<const double *>(d_data.constData() + from);
+
+    *x = values;
+    *y = values + 1;
+    *stride = 2;
+
+    return true;
+}
+
+//! \sa QwtData::copyData()
+void QwtPolygonFData::copyData(size_t from, size_t size,
+    double *x, double *y) const
+{
+    const QPointF *points = d_data.constData() + from;
+    for ( size_t i = 0; i < size; i++ )
+    {
+        x[i] = points[i].x();
+        y[i] = points[i].y();
+    }
+}
+
 //! \return Point array
 const QPolygonF &QwtPolygonFData::data() const
 {
@@ -120,7 +343,33 @@ const QPolygonF &QwtPolygonFData::data() const
 */
 QwtData *QwtPolygonFData::copy() const 
 { 
-    return new QwtPolygonFData(d_data); 
+    QwtPolygonFData *data = new QwtPolygonFData(d_data);
+    data->d_boundingRect = d_boundingRect;
+    data->d_boundingRectValid = d_boundingRectValid;
+
+    return data;
+}
+
+/*!
+  Returns the bounding rectangle of the data. If there is
+  no bounding rect, like for empty data the rectangle is invalid:
+  QwtDoubleRect::isValid() == false
+
+  The rectangle is calculated only once and cached, as the
+  polygon can't be modified.
+*/
+QwtDoubleRect QwtPolygonFData::boundingRect() const
+{
+    if ( !d_boundingRectValid )
+    {
+        const QwtDataBlock block(*this, 0, size());
+
+        d_boundingRect = qwtBoundingRect(block.xData(), block.yData(), 
+            block.size(), block.stride());
+        d_boundingRectValid = true;
+    }
+
+    return d_boundingRect;
 }
 
 /*!
@@ -134,7 +383,8 @@ QwtData *QwtPolygonFData::copy() const
 QwtArrayData::QwtArrayData(
         const QwtArray<double> &x, const QwtArray<double> &y): 
     d_x(x), 
-    d_y(y)
+    d_y(y),
+    d_boundingRectValid(false)
 {
 }
 
@@ -146,7 +396,8 @@ QwtArrayData::QwtArrayData(
   \param size Size of the x and y arrays
   \sa QwtPlotCurve::setData()
 */
-QwtArrayData::QwtArrayData(const double *x, const double *y, size_t size)
+QwtArrayData::QwtArrayData(const double *x, const double *y, size_t size):
+    d_boundingRectValid(false)
 {
     d_x.resize(size);
     memcpy(d_x.data(), x, size * sizeof(double));
@@ -161,6 +412,8 @@ QwtArrayData& QwtArrayData::operator=(const QwtArrayData &data)
     {
         d_x = data.d_x;
         d_y = data.d_y;
+        d_boundingRect = data.d_boundingRect;
+        d_boundingRectValid = data.d_boundingRectValid;
     }
     return *this;
 }
@@ -193,6 +446,25 @@ double QwtArrayData::y(size_t i) const
     return d_y[int(i)]; 
 }
 
+//! \sa QwtData::rawData()
+bool QwtArrayData::rawData(size_t from, const double **x, 
+    const double **y, size_t *stride) const
+{
+    *x = d_x.constData() + from;
+    *y = d_y.constData() + from;
+    *stride = 1;
+
+    return true;
+}
+
+//! \sa QwtData::copyData()
+void QwtArrayData::copyData(size_t from, size_t size,
+    double *x, double *y) const
+{
+    memcpy(x, d_x.constData() + from, size * sizeof(double));
+    memcpy(y, d_y.constData() + from, size * sizeof(double));
+}
+
 //! \return Array of the x-values
 const QwtArray<double> &QwtArrayData::xData() const
 {
@@ -210,43 +482,85 @@ const QwtArray<double> &QwtArrayData::yData() const
 */
 QwtData *QwtArrayData::copy() const 
 { 
-    return new QwtArrayData(d_x, d_y); 
+    QwtArrayData *data = new QwtArrayData(d_x, d_y);
+    data->d_boundingRect = d_boundingRect;
+    data->d_boundingRectValid = d_boundingRectValid;
+
+    return data;
+}
+
+/*!
+  Append a point
+
+  The bounding rectangle is updated in O(1), when it has already
+  been calculated before.
+
+  \param x X value
+  \param y Y value
+  \sa boundingRect()
+*/
+void QwtArrayData::append(double x, double y)
+{
+    append(&x, &y, 1);
+}
+
+/*!
+  Append a series of points
+
+  The bounding rectangle is updated only for the new points,
+  when it has already been calculated before.
+
+  \param x Array of x values
+  \param y Array of y values
+  \param size Size of the x and y arrays
+  \sa boundingRect()
+*/
+void QwtArrayData::append(const double *x, const double *y, size_t size)
+{
+    if ( size == 0 )
+        return;
+
+    const int oldSize = int(this->size());
+    const int newSize = oldSize + int(size);
+
+    d_x.resize(newSize);
+    memcpy(d_x.data() + oldSize, x, size * sizeof(double));
+    d_y.resize(newSize);
+    memcpy(d_y.data() + oldSize, y, size * sizeof(double));
+
+    if ( d_boundingRectValid )
+    {
+        const QwtDoubleRect rect = qwtBoundingRect(x, y, size);
+        if ( oldSize == 0 )
+        {
+            d_boundingRect = rect;
+        }
+        else
+        {
+            qwtExtendRect(d_boundingRect, rect.left(), rect.top());
+            qwtExtendRect(d_boundingRect, rect.right(), rect.bottom());
+        }
+    }
 }
 
 /*!
   Returns the bounding rectangle of the data. If there is
   no bounding rect, like for empty data the rectangle is invalid:
   QwtDoubleRect::isValid() == false
+
+  The rectangle is calculated only once and cached. append()
+  updates the cached rectangle incrementally.
 */
 QwtDoubleRect QwtArrayData::boundingRect() const
 {
-    const size_t sz = size();
-
-    if ( sz <= 0 )
-        return QwtDoubleRect(1.0, 1.0, -2.0, -2.0); // invalid
-
-    double minX, maxX, minY, maxY;
-    QwtArray<double>::ConstIterator xIt = d_x.begin();
-    QwtArray<double>::ConstIterator yIt = d_y.begin();
-    QwtArray<double>::ConstIterator end = d_x.begin() + sz;
-    minX = maxX = *xIt++;
-    minY = maxY = *yIt++;
-
-    while ( xIt < end )
+    if ( !d_boundingRectValid )
     {
-        const double xv = *xIt++;
-        if ( xv < minX )
-            minX = xv;
-        if ( xv > maxX )
-            maxX = xv;
-
-        const double yv = *yIt++;
-        if ( yv < minY )
-            minY = yv;
-        if ( yv > maxY )
-            maxY = yv;
+        d_boundingRect = qwtBoundingRect(
+            d_x.constData(), d_y.constData(), size());
+        d_boundingRectValid = true;
     }
-    return QwtDoubleRect(minX, minY, maxX - minX, maxY - minY);
+
+    return d_boundingRect;
 }
 
 /*!
@@ -310,6 +624,25 @@ double QwtCPointerData::y(size_t i) const
     return d_y[int(i)]; 
 }
 
+//! \sa QwtData::rawData()
+bool QwtCPointerData::rawData(size_t from, const double **x, 
+    const double **y, size_t *stride) const
+{
+    *x = d_x + from;
+    *y = d_y + from;
+    *stride = 1;
+
+    return true;
+}
+
+//! \sa QwtData::copyData()
+void QwtCPointerData::copyData(size_t from, size_t size,
+    double *x, double *y) const
+{
+    memcpy(x, d_x + from, size * sizeof(double));
+    memcpy(y, d_y + from, size * sizeof(double));
+}
+
 //! \return Array of the x-values
 const double *QwtCPointerData::xData() const
 {
@@ -334,34 +667,348 @@ QwtData *QwtCPointerData::copy() const
   Returns the bounding rectangle of the data. If there is
   no bounding rect, like for empty data the rectangle is invalid:
   QwtDoubleRect::isValid() == false
+
+  \note The memory blocks are owned by the application and might
+         be modified behind the back of QwtCPointerData. So the
+         rectangle can't be cached and is recalculated for each call.
 */
 QwtDoubleRect QwtCPointerData::boundingRect() const
 {
-    const size_t sz = size();
+    return qwtBoundingRect(d_x, d_y, d_size);
+}
+
+/*!
+  Constructor
+
+  \param capacity Maximum number of points
+  \sa setCapacity()
+*/
+QwtRingBufferData::QwtRingBufferData(size_t capacity):
+    d_capacity(0),
+    d_first(0),
+    d_size(0),
+    d_appendCount(0),
+    d_xAscending(true),
+    d_boundingRectValid(false),
+    d_minXCount(0),
+    d_maxXCount(0),
+    d_minYCount(0),
+    d_maxYCount(0)
+{
+    setCapacity(capacity);
+}
+
+//! Assignment 
+QwtRingBufferData& QwtRingBufferData::operator=(
+    const QwtRingBufferData &data)
+{
+    if (this != &data)
+    {
+        d_capacity = data.d_capacity;
+        d_first = data.d_first;
+        d_size = data.d_size;
+        d_appendCount = data.d_appendCount;
+        d_x = data.d_x;
+        d_y = data.d_y;
+        d_xAscending = data.d_xAscending;
+        d_boundingRect = data.d_boundingRect;
+        d_boundingRectValid = data.d_boundingRectValid;
+        d_minXCount = data.d_minXCount;
+        d_maxXCount = data.d_maxXCount;
+        d_minYCount = data.d_minYCount;
+        d_maxYCount = data.d_maxYCount;
+    }
+    return *this;
+}
+
+/*!
+  \return Pointer to a copy (virtual copy constructor)
+  \note The buffers are implicitly shared, the points are copied
+        with the first append() to one of the objects.
+*/
+QwtData *QwtRingBufferData::copy() const 
+{
+    QwtRingBufferData *data = new QwtRingBufferData(0);
+    *data = *this;
+
+    return data;
+}
+
+/*!
+  Change the maximum number of points
+
+  When the buffer contains more than capacity points the oldest
+  points are dropped.
+
+  \param capacity Maximum number of points
+  \sa capacity()
+*/
+void QwtRingBufferData::setCapacity(size_t capacity)
+{
+    if ( capacity == d_capacity )
+        return;
+
+    const size_t size = qwtMin(d_size, capacity);
+    const size_t from = d_size - size;
+
+    QwtArray<double> x(int(2 * capacity));
+    QwtArray<double> y(int(2 * capacity));
+
+    if ( size > 0 )
+    {
+        copyData(from, size, x.data(), y.data());
+        memcpy(x.data() + capacity, x.constData(), size * sizeof(double));
+        memcpy(y.data() + capacity, y.constData(), size * sizeof(double));
+    }
+
+    d_x = x;
+    d_y = y;
+    d_capacity = capacity;
+    d_first = 0;
+    d_size = size;
+
+    if ( from > 0 )
+        d_boundingRectValid = false;
+}
+
+/*!
+  \return Maximum number of points
+  \sa setCapacity()
+*/
+size_t QwtRingBufferData::capacity() const
+{
+    return d_capacity;
+}
+
+/*!
+  Append a point
+
+  When the buffer is full, the oldest point is dropped.
+
+  \param x X value
+  \param y Y value
+*/
+void QwtRingBufferData::append(double x, double y)
+{
+    if ( d_capacity == 0 )
+        return;
+
+    if ( d_xAscending && d_size > 0 && x < this->x(d_size - 1) )
+    {
+        // the x interval hasn't been tracked so far
+        d_xAscending = false;
+        d_boundingRectValid = false;
+    }
+
+    size_t pos;
+    if ( d_size < d_capacity )
+    {
+        pos = d_first + d_size;
+        if ( pos >= d_capacity )
+            pos -= d_capacity;
+
+        d_size++;
+    }
+    else
+    {
+        pos = d_first;
+
+        if ( d_boundingRectValid )
+        {
+            // When the last value equal to an extreme drops out,
+            // the rectangle might shrink and needs to be recalculated.
+
+            if ( !qwtRemoveFromInterval(d_boundingRect.top(),
+                d_boundingRect.bottom(), d_minYCount, d_maxYCount,
+                d_y[int(pos)]) )
+            {
+                d_boundingRectValid = false;
+            }
+
+            if ( !d_xAscending && !qwtRemoveFromInterval(
+                d_boundingRect.left(), d_boundingRect.right(),
+                d_minXCount, d_maxXCount, d_x[int(pos)]) )
+            {
+                d_boundingRectValid = false;
+            }
+        }
+
+        d_first++;
+        if ( d_first == d_capacity )
+            d_first = 0;
+    }
+
+    double *xData = d_x.data();
+    double *yData = d_y.data();
+
+    xData[pos] = xData[pos + d_capacity] = x;
+    yData[pos] = yData[pos + d_capacity] = y;
+
+    d_appendCount++;
+
+    if ( d_boundingRectValid )
+    {
+        if ( d_size == 1 )
+        {
+            d_boundingRect = QwtDoubleRect(x, y, 0.0, 0.0);
+            d_minXCount = d_maxXCount = 1;
+            d_minYCount = d_maxYCount = 1;
+        }
+        else
+        {
+            double minX = d_boundingRect.left();
+            double maxX = d_boundingRect.right();
+            double minY = d_boundingRect.top();
+            double maxY = d_boundingRect.bottom();
+
+            qwtExtendInterval(minX, maxX, d_minXCount, d_maxXCount, x);
+            qwtExtendInterval(minY, maxY, d_minYCount, d_maxYCount, y);
+
+            d_boundingRect.setCoords(minX, minY, maxX, maxY);
+        }
+    }
+}
+
+/*!
+  Append a series of points
+
+  When the buffer is full, the oldest points are dropped.
+
+  \param x Array of x values
+  \param y Array of y values
+  \param size Size of the x and y arrays
+*/
+void QwtRingBufferData::append(const double *x, const double *y, 
+    size_t size)
+{
+    for ( size_t i = 0; i < size; i++ )
+        append(x[i], y[i]);
+}
 
-    if ( sz <= 0 )
+//! Remove all points
+void QwtRingBufferData::clear()
+{
+    d_first = 0;
+    d_size = 0;
+    d_xAscending = true;
+    d_boundingRectValid = false;
+}
+
+/*!
+  \return Number of points, that have been appended since the buffer
+          has been created. As this number is only increasing, it can
+          be used to find out how many points have been appended since
+          the last check. appendCount() - size() is the number of points,
+          that have been dropped.
+  \sa QwtData::appendCount(), QwtPlotCurve::drawAppended()
+*/
+size_t QwtRingBufferData::appendCount() const
+{
+    return d_appendCount;
+}
+
+//! \return Size of the data set 
+size_t QwtRingBufferData::size() const 
+{   
+    return d_size; 
+}
+
+/*!
+  Return the x value of data point i
+
+  \param i Index, where 0 is the oldest point
+  \return x X value of data point i
+*/
+double QwtRingBufferData::x(size_t i) const 
+{ 
+    return d_x[int(d_first + i)]; 
+}
+
+/*!
+  Return the y value of data point i
+
+  \param i Index, where 0 is the oldest point
+  \return y Y value of data point i
+*/
+double QwtRingBufferData::y(size_t i) const 
+{ 
+    return d_y[int(d_first + i)]; 
+}
+
+/*!
+  \brief Direct access to the memory of the buffer
+
+  As each value is stored twice, any range of points is
+  contiguous in memory.
+
+  \sa QwtData::rawData()
+*/
+bool QwtRingBufferData::rawData(size_t from, const double **x, 
+    const double **y, size_t *stride) const
+{
+    *x = d_x.constData() + d_first + from;
+    *y = d_y.constData() + d_first + from;
+    *stride = 1;
+
+    return true;
+}
+
+//! \sa QwtData::copyData()
+void QwtRingBufferData::copyData(size_t from, size_t size,
+    double *x, double *y) const
+{
+    memcpy(x, d_x.constData() + d_first + from, size * sizeof(double));
+    memcpy(y, d_y.constData() + d_first + from, size * sizeof(double));
+}
+
+/*!
+  Returns the bounding rectangle of the data. If there is
+  no bounding rect, like for empty data the rectangle is invalid:
+  QwtDoubleRect::isValid() == false
+
+  The rectangle is cached and updated in O(1) for appended points.
+  It is only recalculated, when the last of the values equal to an
+  extreme has been dropped.
+  For ascending x values the x interval is always taken from the 
+  first and the last point.
+*/
+QwtDoubleRect QwtRingBufferData::boundingRect() const
+{
+    if ( d_size == 0 )
         return QwtDoubleRect(1.0, 1.0, -2.0, -2.0); // invalid
 
-    double minX, maxX, minY, maxY;
-    const double *xIt = d_x;
-    const double *yIt = d_y;
-    const double *end = d_x + sz;
-    minX = maxX = *xIt++;
-    minY = maxY = *yIt++;
+    const double *xData = d_x.constData() + d_first;
+    const double *yData = d_y.constData() + d_first;
 
-    while ( xIt < end )
+    if ( !d_boundingRectValid )
     {
-        const double xv = *xIt++;
-        if ( xv < minX )
-            minX = xv;
-        if ( xv > maxX )
-            maxX = xv;
-
-        const double yv = *yIt++;
-        if ( yv < minY )
-            minY = yv;
-        if ( yv > maxY )
-            maxY = yv;
+        if ( d_xAscending )
+        {
+            double minY, maxY;
+            qwtGetMinMax(yData, d_size, minY, maxY);
+
+            d_boundingRect.setCoords(xData[0], minY, 
+                xData[d_size - 1], maxY);
+        }
+        else
+        {
+            d_boundingRect = qwtBoundingRect(xData, yData, d_size);
+
+            d_minXCount = qwtCountEqual(xData, d_size, d_boundingRect.left());
+            d_maxXCount = qwtCountEqual(xData, d_size, d_boundingRect.right());
+        }
+
+        d_minYCount = qwtCountEqual(yData, d_size, d_boundingRect.top());
+        d_maxYCount = qwtCountEqual(yData, d_size, d_boundingRect.bottom());
+
+        d_boundingRectValid = true;
     }
-    return QwtDoubleRect(minX, minY, maxX - minX, maxY - minY);
+    else if ( d_xAscending )
+    {
+        // dropped points don't invalidate the x interval
+        d_boundingRect.setLeft(xData[0]);
+        d_boundingRect.setRight(xData[d_size - 1]);
+    }
+
+    return d_boundingRect;
 }
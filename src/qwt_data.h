@@ -53,6 +53,13 @@ public:
 
     virtual QwtDoubleRect boundingRect() const;
 
+    virtual bool rawData(size_t from, const double **x, const double **y,
+        size_t *stride) const;
+    virtual void copyData(size_t from, size_t size,
+        double *x, double *y) const;
+
+    virtual size_t appendCount() const;
+
 protected:
     /*!
       Assignment operator (virtualized)
@@ -60,6 +67,57 @@ protected:
     QwtData &operator=(const QwtData &);
 };
 
+/*!
+  \brief Contiguous read access to a range of points of a QwtData object
+
+  QwtDataBlock avoids the virtual QwtData::x()/QwtData::y() calls 
+  for each point in loops over many points. If the data object offers 
+  direct access to its memory ( QwtData::rawData() ) the block refers
+  to it without copying. Otherwise the range is copied into an 
+  internal buffer using QwtData::copyData().
+
+  \warning The block is only valid as long as the data object
+           is not modified or deleted.
+*/
+class QWT_EXPORT QwtDataBlock
+{
+public:
+    QwtDataBlock(const QwtData &, size_t from, size_t size);
+
+    //! \return Number of points in the block
+    inline size_t size() const { return d_size; }
+
+    /*!
+      \return x value of point i
+      \param i Index relative to the first point of the block
+     */
+    inline double x(size_t i) const { return d_x[i * d_stride]; }
+
+    /*!
+      \return y value of point i
+      \param i Index relative to the first point of the block
+     */
+    inline double y(size_t i) const { return d_y[i * d_stride]; }
+
+    //! \return Pointer to the x value of the first point
+    inline const double *xData() const { return d_x; }
+    //! \return Pointer to the y value of the first point
+    inline const double *yData() const { return d_y; }
+    //! \return Distance ( in doubles ) between 2 consecutive values
+    inline size_t stride() const { return d_stride; }
+
+private:
+    QwtDataBlock( const QwtDataBlock & );
+    QwtDataBlock &operator=( const QwtDataBlock & );
+
+    const double *d_x;
+    const double *d_y;
+    size_t d_stride;
+    size_t d_size;
+
+    QwtArray<double> d_buffer;
+};
+
 
 /*!
   \brief Data class containing a single QwtArray<QwtDoublePoint> object. 
@@ -76,10 +134,20 @@ public:
     virtual double x(size_t i) const;
     virtual double y(size_t i) const;
 
+    virtual bool rawData(size_t from, const double **x, const double **y,
+        size_t *stride) const;
+    virtual void copyData(size_t from, size_t size,
+        double *x, double *y) const;
+
     const QPolygonF &data() const;
 
+    virtual QwtDoubleRect boundingRect() const;
+
 private:
     QPolygonF d_data;
+
+    mutable QwtDoubleRect d_boundingRect;
+    mutable bool d_boundingRectValid;
 };
 
 /*!
@@ -98,14 +166,25 @@ public:
     virtual double x(size_t i) const;
     virtual double y(size_t i) const;
 
+    virtual bool rawData(size_t from, const double **x, const double **y,
+        size_t *stride) const;
+    virtual void copyData(size_t from, size_t size,
+        double *x, double *y) const;
+
     const QwtArray<double> &xData() const;
     const QwtArray<double> &yData() const;
 
+    void append(double x, double y);
+    void append(const double *x, const double *y, size_t size);
+
     virtual QwtDoubleRect boundingRect() const;
 
 private:
     QwtArray<double> d_x;
     QwtArray<double> d_y;
+
+    mutable QwtDoubleRect d_boundingRect;
+    mutable bool d_boundingRectValid;
 };
 
 /*!
@@ -122,6 +201,11 @@ public:
     virtual double x(size_t i) const;
     virtual double y(size_t i) const;
 
+    virtual bool rawData(size_t from, const double **x, const double **y,
+        size_t *stride) const;
+    virtual void copyData(size_t from, size_t size,
+        double *x, double *y) const;
+
     const double *xData() const;
     const double *yData() const;
 
@@ -133,4 +217,73 @@ private:
     size_t d_size;
 };
 
+/*!
+  \brief Data class for streaming data, stored in a circular buffer
+
+  QwtRingBufferData keeps the most recent capacity() points. Appending
+  a point is O(1): when the buffer is full, the oldest point is dropped.
+  It is intended for curves, that display a live feed of samples:
+
+  \verbatim
+curve->setData(QwtRingBufferData(10000));
+...
+QwtRingBufferData &buffer = (QwtRingBufferData &)curve->data();
+buffer.append(xValues, yValues, count);
+
+if ( !curve->drawAppended() )
+    plot->replot();
+\endverbatim
+
+  Each value is stored twice, so that any range of points can be 
+  accessed as contiguous memory ( see rawData() ).
+
+  \sa QwtPlotCurve::drawAppended()
+*/
+class QWT_EXPORT QwtRingBufferData: public QwtData
+{
+public:
+    QwtRingBufferData(size_t capacity);
+    QwtRingBufferData &operator=(const QwtRingBufferData &);
+    virtual QwtData *copy() const;
+
+    void setCapacity(size_t capacity);
+    size_t capacity() const;
+
+    void append(double x, double y);
+    void append(const double *x, const double *y, size_t size);
+    void clear();
+
+    virtual size_t appendCount() const;
+
+    virtual size_t size() const;
+    virtual double x(size_t i) const;
+    virtual double y(size_t i) const;
+
+    virtual bool rawData(size_t from, const double **x, const double **y,
+        size_t *stride) const;
+    virtual void copyData(size_t from, size_t size,
+        double *x, double *y) const;
+
+    virtual QwtDoubleRect boundingRect() const;
+
+private:
+    size_t d_capacity;
+    size_t d_first;
+    size_t d_size;
+    size_t d_appendCount;
+
+    QwtArray<double> d_x;
+    QwtArray<double> d_y;
+
+    bool d_xAscending;
+    mutable QwtDoubleRect d_boundingRect;
+    mutable bool d_boundingRectValid;
+
+    // number of values, that are equal to the extremes
+    mutable size_t d_minXCount;
+    mutable size_t d_maxXCount;
+    mutable size_t d_minYCount;
+    mutable size_t d_maxYCount;
+};
+
 #endif // !QWT_DATA
@@ -0,0 +1,507 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include <math.h>
+#include "qwt_math.h"
+#include "qwt_data.h"
+#include "qwt_scale_map.h"
+#include "qwt_column_reducer.h"
+#include "qwt_data_pyramid.h"
+
+// number of points of a bucket on the lowest level
+static const size_t qwtBucketSize = 32;
+
+// number of buckets, that are merged into a bucket of the next level
+static const size_t qwtFanOut = 4;
+
+// number of buckets, that are initialized from one QwtDataBlock
+static const size_t qwtBlockBuckets = 256;
+
+class QwtDataPyramid::Bucket
+{
+public:
+    QwtDoublePoint first;
+    QwtDoublePoint last;
+
+    // points with the minimum/maximum of the aggregated coordinate
+    QwtDoublePoint min;
+    QwtDoublePoint max;
+    size_t minIndex;
+    size_t maxIndex;
+
+    // interval of the other coordinate
+    double lower;
+    double upper;
+};
+
+class QwtDataPyramid::PrivateData
+{
+public:
+    class Level
+    {
+    public:
+        Level():
+            base(0)
+        {
+        }
+
+        /*
+          Make the buckets [first, last] available. Buckets in front
+          of first contain dropped points only. They are removed, when
+          they are more than the valid buckets, so that dropping points
+          costs amortized O(1).
+         */
+        void sync(size_t first, size_t last)
+        {
+            const size_t numDropped = first - base;
+            if ( numDropped >= size_t(buckets.size()) )
+            {
+                buckets.clear();
+                base = first;
+            }
+            else if ( numDropped > last - first + 1 )
+            {
+                buckets.remove(0, int(numDropped));
+                base = first;
+            }
+
+            buckets.resize(int(last - base + 1));
+        }
+
+        // position of the first bucket of the array
+        size_t base;
+        QwtArray<QwtDataPyramid::Bucket> buckets;
+    };
+
+    PrivateData():
+        orientation(Qt::Vertical),
+        dataSize(0),
+        offset(0),
+        appendCount(0)
+    {
+    }
+
+    inline double value(const QwtDoublePoint &pos) const
+    {
+        return orientation == Qt::Vertical ? pos.y() : pos.x();
+    }
+
+    inline double position(const QwtDoublePoint &pos) const
+    {
+        return orientation == Qt::Vertical ? pos.x() : pos.y();
+    }
+
+    inline const QwtDataPyramid::Bucket &bucket(
+        int level, size_t index) const
+    {
+        const Level &l = levels[level];
+        return l.buckets[int(index - l.base)];
+    }
+
+    Qt::Orientation orientation;
+    size_t dataSize;
+
+    /*
+      Buckets are aligned to the position of a point in the sequence
+      of all points, that have ever been appended. As the position of
+      a point doesn't change, when points are dropped from the beginning
+      of streaming data ( see QwtData::appendCount() ), only the buckets
+      of the new points have to be calculated.
+     */
+    size_t offset;
+    size_t appendCount;
+
+    QwtArray<Level> levels;
+};
+
+/*
+  Buckets are not aligned to pixel columns. Consecutive points,
+  that are mapped to the same column are reduced to the first,
+  minimum, maximum and last point of the column.
+ */
+static void qwtReduceColumns(QwtArray<QwtDoublePoint> &points,
+    const QwtScaleMap &map, Qt::Orientation orientation)
+{
+    const bool vertical = orientation == Qt::Vertical;
+
+    QwtArray<QwtDoublePoint> reduced;
+    reduced.reserve(points.size());
+
+    {
+        QwtColumnReducer reducer(reduced);
+
+        for ( int i = 0; i < points.size(); i++ )
+        {
+            const QwtDoublePoint &pos = points[i];
+
+            if ( vertical )
+                reducer.append(::floor(map.xTransform(pos.x())), pos.y(), pos);
+            else
+                reducer.append(::floor(map.xTransform(pos.y())), pos.x(), pos);
+        }
+    }
+
+    points = reduced;
+}
+
+/*!
+  Constructor
+
+  \param orientation Qt::Vertical, when the y coordinates are
+                     aggregated, otherwise Qt::Horizontal
+*/
+QwtDataPyramid::QwtDataPyramid(Qt::Orientation orientation)
+{
+    d_data = new PrivateData;
+    d_data->orientation = orientation;
+}
+
+//! Destructor
+QwtDataPyramid::~QwtDataPyramid()
+{
+    delete d_data;
+}
+
+/*!
+  Change the orientation
+
+  As the buckets depend on the orientation, the pyramid is invalidated.
+
+  \param orientation Qt::Vertical, when the y coordinates are
+                     aggregated, otherwise Qt::Horizontal
+  \sa orientation(), invalidate()
+*/
+void QwtDataPyramid::setOrientation(Qt::Orientation orientation)
+{
+    if ( orientation != d_data->orientation )
+    {
+        d_data->orientation = orientation;
+        invalidate();
+    }
+}
+
+/*!
+  \return Orientation
+  \sa setOrientation()
+*/
+Qt::Orientation QwtDataPyramid::orientation() const
+{
+    return d_data->orientation;
+}
+
+//! Remove all levels
+void QwtDataPyramid::invalidate()
+{
+    d_data->levels.clear();
+    d_data->dataSize = 0;
+    d_data->offset = 0;
+    d_data->appendCount = 0;
+}
+
+//! \return Number of points, the pyramid has been built for
+size_t QwtDataPyramid::dataSize() const
+{
+    return d_data->dataSize;
+}
+
+//! \return Number of levels
+int QwtDataPyramid::levelCount() const
+{
+    return d_data->levels.size();
+}
+
+/*!
+  \brief Update the pyramid for modified points
+
+  All buckets, that contain points with an index >= from are
+  recalculated. For a series, where points have been appended,
+  from is the number of points before the append operation
+  and the effort of the update is proportional to the number
+  of new points.
+
+  For streaming data ( see QwtData::appendCount() ) points, that
+  have been dropped from the beginning, are detected by the pyramid.
+  Then update(data, dataSize()) recalculates only the buckets
+  of the appended points.
+
+  \param data Series of points
+  \param from Index of the first modified point of the series,
+              that has been passed to the previous update.
+  \sa invalidate()
+*/
+void QwtDataPyramid::update(const QwtData &data, size_t from)
+{
+    const size_t numPoints = data.size();
+    const size_t appendCount = data.appendCount();
+
+    const bool isStreaming = appendCount >= numPoints && appendCount > 0;
+    const bool wasStreaming = d_data->appendCount > 0;
+
+    const size_t offset = isStreaming ? appendCount - numPoints : 0;
+    const size_t end = offset + numPoints;
+
+    if ( isStreaming != wasStreaming || appendCount < d_data->appendCount
+        || offset < d_data->offset )
+    {
+        // the points are not related to the previous points
+        d_data->levels.clear();
+    }
+
+    // position of the first modified point
+    size_t modified = offset;
+    if ( !d_data->levels.isEmpty() )
+    {
+        modified = d_data->offset + qwtMin(from, d_data->dataSize);
+        modified = qwtLim(modified, offset, end);
+    }
+
+    d_data->dataSize = numPoints;
+    d_data->offset = offset;
+    d_data->appendCount = appendCount;
+
+    if ( numPoints == 0 )
+    {
+        d_data->levels.clear();
+        return;
+    }
+
+    if ( d_data->levels.isEmpty() )
+    {
+        d_data->levels.resize(1);
+        d_data->levels[0].base = offset / qwtBucketSize;
+    }
+
+    size_t lowerFirst = offset / qwtBucketSize;
+    size_t lowerLast = ( end - 1 ) / qwtBucketSize;
+
+    PrivateData::Level &level0 = d_data->levels[0];
+    level0.sync(lowerFirst, lowerLast);
+
+    for ( size_t b1 = modified / qwtBucketSize;
+        b1 <= lowerLast; b1 += qwtBlockBuckets )
+    {
+        const size_t b2 = qwtMin(b1 + qwtBlockBuckets - 1, lowerLast);
+
+        const size_t i1 = qwtMax(b1 * qwtBucketSize, offset);
+        const size_t i2 = qwtMin(( b2 + 1 ) * qwtBucketSize, end);
+
+        const QwtDataBlock block(data, i1 - offset, i2 - i1);
+
+        for ( size_t b = b1; b <= b2; b++ )
+        {
+            const size_t j1 = qwtMax(b * qwtBucketSize, i1) - i1;
+            const size_t j2 = qwtMin(( b + 1 ) * qwtBucketSize, i2) - i1;
+
+            Bucket &bucket = level0.buckets[int(b - level0.base)];
+
+            QwtDoublePoint pos(block.x(j1), block.y(j1));
+
+            bucket.first = bucket.min = bucket.max = pos;
+            bucket.minIndex = bucket.maxIndex = i1 + j1;
+            bucket.lower = bucket.upper = d_data->position(pos);
+
+            for ( size_t j = j1 + 1; j < j2; j++ )
+            {
+                pos = QwtDoublePoint(block.x(j), block.y(j));
+
+                const double v = d_data->value(pos);
+                if ( v < d_data->value(bucket.min) )
+                {
+                    bucket.min = pos;
+                    bucket.minIndex = i1 + j;
+                }
+                else if ( v > d_data->value(bucket.max) )
+                {
+                    bucket.max = pos;
+                    bucket.maxIndex = i1 + j;
+                }
+
+                const double p = d_data->position(pos);
+                if ( p < bucket.lower )
+                    bucket.lower = p;
+                else if ( p > bucket.upper )
+                    bucket.upper = p;
+            }
+
+            bucket.last = pos;
+        }
+    }
+
+    size_t first = modified / qwtBucketSize;
+
+    int level = 1;
+    for ( ; lowerLast > lowerFirst; level++ )
+    {
+        const size_t levelFirst = lowerFirst / qwtFanOut;
+        const size_t levelLast = lowerLast / qwtFanOut;
+
+        first /= qwtFanOut;
+        if ( level >= d_data->levels.size() )
+        {
+            d_data->levels.resize(level + 1);
+            d_data->levels[level].base = levelFirst;
+            first = levelFirst;
+        }
+
+        const PrivateData::Level &lower = d_data->levels[level - 1];
+        PrivateData::Level &upper = d_data->levels[level];
+
+        upper.sync(levelFirst, levelLast);
+
+        for ( size_t b = qwtMax(first, levelFirst); b <= levelLast; b++ )
+        {
+            // children in front of lowerFirst contain dropped points only
+            const size_t c1 = qwtMax(b * qwtFanOut, lowerFirst);
+            const size_t c2 = qwtMin(( b + 1 ) * qwtFanOut - 1, lowerLast);
+
+            Bucket &bucket = upper.buckets[int(b - upper.base)];
+            bucket = lower.buckets[int(c1 - lower.base)];
+
+            for ( size_t c = c1 + 1; c <= c2; c++ )
+            {
+                const Bucket &child = lower.buckets[int(c - lower.base)];
+
+                if ( d_data->value(child.min) < d_data->value(bucket.min) )
+                {
+                    bucket.min = child.min;
+                    bucket.minIndex = child.minIndex;
+                }
+                if ( d_data->value(child.max) > d_data->value(bucket.max) )
+                {
+                    bucket.max = child.max;
+                    bucket.maxIndex = child.maxIndex;
+                }
+
+                bucket.lower = qwtMin(bucket.lower, child.lower);
+                bucket.upper = qwtMax(bucket.upper, child.upper);
+            }
+
+            bucket.last = lower.buckets[int(c2 - lower.base)].last;
+        }
+
+        lowerFirst = levelFirst;
+        lowerLast = levelLast;
+    }
+
+    d_data->levels.resize(level);
+}
+
+/*!
+  \brief Find the points, that are necessary to paint a range of points
+
+  The pyramid is traversed from the top. Buckets, that are completely
+  inside of the range and whose points are mapped into the same pixel
+  column ( row for Qt::Horizontal ) are represented by their first,
+  minimum, maximum and last point. All other buckets are split into
+  the buckets of the level below, or into their points on the lowest
+  level.
+
+  \param data Series of points, the pyramid has been built for
+  \param map Map for the coordinate, that is not aggregated.
+             For Qt::Vertical this is the x map.
+  \param from Index of the first point
+  \param to Index of the last point
+
+  \return Points in the order of the series
+  \sa update()
+*/
+QwtArray<QwtDoublePoint> QwtDataPyramid::points(const QwtData &data,
+    const QwtScaleMap &map, size_t from, size_t to) const
+{
+    QwtArray<QwtDoublePoint> points;
+
+    const int numLevels = d_data->levels.size();
+    if ( numLevels == 0 || d_data->dataSize == 0 )
+        return points;
+
+    to = qwtMin(to, d_data->dataSize - 1);
+    if ( from > to )
+        return points;
+
+    // positions of the points since the first append
+
+    from += d_data->offset;
+    to += d_data->offset;
+
+    const int top = numLevels - 1;
+
+    size_t bucketSize = qwtBucketSize;
+    for ( int i = 0; i < top; i++ )
+        bucketSize *= qwtFanOut;
+
+    const size_t b2 = to / bucketSize;
+    for ( size_t b = from / bucketSize; b <= b2; b++ )
+        appendPoints(points, data, map, top, b, from, to);
+
+    qwtReduceColumns(points, map, d_data->orientation);
+
+    return points;
+}
+
+void QwtDataPyramid::appendPoints(QwtArray<QwtDoublePoint> &points,
+    const QwtData &data, const QwtScaleMap &map,
+    int level, size_t index, size_t from, size_t to) const
+{
+    size_t bucketSize = qwtBucketSize;
+    for ( int i = 0; i < level; i++ )
+        bucketSize *= qwtFanOut;
+
+    const size_t offset = d_data->offset;
+
+    // a bucket, that starts in front of from, might contain
+    // points, that have been dropped, and is never used as a whole
+
+    const size_t first = index * bucketSize;
+    const size_t last = qwtMin(first + bucketSize,
+        offset + d_data->dataSize) - 1;
+
+    const Bucket &bucket = d_data->bucket(level, index);
+
+    if ( first >= from && last <= to &&
+        ::floor(map.xTransform(bucket.lower)) ==
+            ::floor(map.xTransform(bucket.upper)) )
+    {
+        QwtDoublePoint p1 = bucket.min;
+        QwtDoublePoint p2 = bucket.max;
+        size_t i1 = bucket.minIndex;
+        size_t i2 = bucket.maxIndex;
+
+        if ( i1 > i2 )
+        {
+            qSwap(p1, p2);
+            qSwap(i1, i2);
+        }
+
+        points += bucket.first;
+        if ( i1 > first && i1 < last )
+            points += p1;
+        if ( i2 > i1 && i2 < last )
+            points += p2;
+        if ( last > first )
+            points += bucket.last;
+
+        return;
+    }
+
+    if ( level == 0 )
+    {
+        const size_t i2 = qwtMin(last, to);
+        for ( size_t i = qwtMax(first, from); i <= i2; i++ )
+            points += QwtDoublePoint(data.x(i - offset), data.y(i - offset));
+
+        return;
+    }
+
+    const size_t c1 = qwtMax(index * qwtFanOut, from / (bucketSize / qwtFanOut));
+    const size_t c2 = qwtMin((index + 1) * qwtFanOut - 1,
+        to / (bucketSize / qwtFanOut));
+
+    for ( size_t c = c1; c <= c2; c++ )
+        appendPoints(points, data, map, level - 1, c, from, to);
+}
@@ -0,0 +1,73 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_DATA_PYRAMID_H
+#define QWT_DATA_PYRAMID_H 1
+
+#include <qnamespace.h>
+#include "qwt_global.h"
+#include "qwt_array.h"
+#include "qwt_double_rect.h"
+
+class QwtData;
+class QwtScaleMap;
+
+/*!
+  \brief Multi resolution min/max aggregation of a series of points
+
+  QwtDataPyramid divides a series of points into buckets of consecutive
+  points and stores the first, the last, the minimum and the maximum
+  point of each bucket. Higher levels of the pyramid merge the buckets
+  of the level below, until one bucket covers all points.
+
+  points() walks down the pyramid and returns for each bucket, whose
+  points fall into a single pixel column, only its first, minimum,
+  maximum and last point. Connecting these points results in the same
+  pixels as connecting all points of the bucket, but the number of
+  points to be mapped and painted is proportional to the width of
+  the canvas instead of the size of the series.
+
+  The orientation indicates the coordinate, that is aggregated:
+  Qt::Vertical aggregates the y coordinates of curves,
+  where y is a function of x.
+
+  \sa QwtPlotCurve::PaintLevelOfDetail
+*/
+class QWT_EXPORT QwtDataPyramid
+{
+public:
+    explicit QwtDataPyramid(Qt::Orientation = Qt::Vertical);
+    ~QwtDataPyramid();
+
+    void setOrientation(Qt::Orientation);
+    Qt::Orientation orientation() const;
+
+    void update(const QwtData &, size_t from = 0);
+    void invalidate();
+
+    size_t dataSize() const;
+    int levelCount() const;
+
+    QwtArray<QwtDoublePoint> points(const QwtData &,
+        const QwtScaleMap &, size_t from, size_t to) const;
+
+private:
+    QwtDataPyramid(const QwtDataPyramid &);
+    QwtDataPyramid &operator=(const QwtDataPyramid &);
+
+    class Bucket;
+    void appendPoints(QwtArray<QwtDoublePoint> &, const QwtData &,
+        const QwtScaleMap &, int level, size_t index,
+        size_t from, size_t to) const;
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+#endif
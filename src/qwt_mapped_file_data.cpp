@@ -0,0 +1,453 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include <qfile.h>
+#include <qstring.h>
+#include "qwt_math.h"
+#include "qwt_mapped_file_data.h"
+
+// number of values, that are converted at once, when scanning floats
+static const size_t qwtChunkSize = 4096;
+
+class QwtMappedFileData::PrivateData
+{
+public:
+    PrivateData():
+        valueType(QwtMappedFileData::Double),
+        offset(0),
+        interleaved(false),
+        xValues(nullptr),
+        yValues(nullptr),
+        stride(1),
+        size(0),
+        boundingRectValid(false)
+    {
+    }
+
+    template <typename T>
+    inline T value(const uchar *values, size_t i) const
+    {
+        return reinterpret_cast<const T *>(values)[i * stride];
+    }
+
+    inline double xValue(size_t i) const
+    {
+        if ( valueType == QwtMappedFileData::Float )
+            return value<float>(xValues, i);
+
+        return value<double>(xValues, i);
+    }
+
+    inline double yValue(size_t i) const
+    {
+        if ( valueType == QwtMappedFileData::Float )
+            return value<float>(yValues, i);
+
+        return value<double>(yValues, i);
+    }
+
+    QwtMappedFileData::ValueType valueType;
+    qint64 offset;
+    bool interleaved;
+
+    QFile xFile;
+    QFile yFile;
+
+    const uchar *xValues;
+    const uchar *yValues;
+    size_t stride;
+    size_t size;
+
+    mutable QwtDoubleRect boundingRect;
+    mutable bool boundingRectValid;
+};
+
+static size_t qwtValueSize(QwtMappedFileData::ValueType type)
+{
+    return type == QwtMappedFileData::Float ? sizeof(float) : sizeof(double);
+}
+
+static const uchar *qwtMapFile(QFile &file, qint64 offset,
+    size_t valueSize, size_t &count)
+{
+    count = 0;
+
+    if ( offset < 0 || offset % valueSize != 0 )
+        return nullptr;
+
+    if ( !file.open(QIODevice::ReadOnly) )
+        return nullptr;
+
+    const qint64 numBytes = file.size() - offset;
+    if ( numBytes < qint64(valueSize) )
+        return nullptr;
+
+    // ignore a trailing incomplete value
+    const qint64 mapSize = numBytes - numBytes % valueSize;
+
+    const uchar *values = file.map(offset, mapSize);
+    if ( values )
+        count = size_t(mapSize / valueSize);
+
+    return values;
+}
+
+/*!
+  Constructor for a series stored in two files
+
+  \param xFileName File with the x values
+  \param yFileName File with the y values
+  \param valueType Type of the values
+  \param offset Number of bytes at the beginning of both files,
+                that have to be skipped. It has to be a multiple of
+                the size of a value.
+
+  When the files have different sizes the number of points is
+  limited by the shorter file.
+
+  \sa isValid()
+*/
+QwtMappedFileData::QwtMappedFileData(
+        const QString &xFileName, const QString &yFileName,
+        ValueType valueType, qint64 offset)
+{
+    d_data = new PrivateData;
+    d_data->valueType = valueType;
+    d_data->offset = offset;
+    d_data->interleaved = false;
+    d_data->xFile.setFileName(xFileName);
+    d_data->yFile.setFileName(yFileName);
+
+    map();
+}
+
+/*!
+  Constructor for a series, stored interleaved in a single file
+
+  \param fileName File with the values ( x0, y0, x1, y1, ... )
+  \param valueType Type of the values
+  \param offset Number of bytes at the beginning of the file, that
+                have to be skipped. It has to be a multiple of
+                the size of a value.
+
+  \sa isValid()
+*/
+QwtMappedFileData::QwtMappedFileData(const QString &fileName,
+        ValueType valueType, qint64 offset)
+{
+    d_data = new PrivateData;
+    d_data->valueType = valueType;
+    d_data->offset = offset;
+    d_data->interleaved = true;
+    d_data->xFile.setFileName(fileName);
+
+    map();
+}
+
+//! Destructor, unmaps the files
+QwtMappedFileData::~QwtMappedFileData()
+{
+    unmap();
+    delete d_data;
+}
+
+/*!
+  Assignment
+
+  The files of data are mapped again, the bounding rectangle
+  is taken over.
+*/
+QwtMappedFileData& QwtMappedFileData::operator=(
+    const QwtMappedFileData &data)
+{
+    if (this != &data)
+    {
+        unmap();
+
+        d_data->valueType = data.d_data->valueType;
+        d_data->offset = data.d_data->offset;
+        d_data->interleaved = data.d_data->interleaved;
+        d_data->xFile.setFileName(data.d_data->xFile.fileName());
+        d_data->yFile.setFileName(data.d_data->yFile.fileName());
+
+        map();
+
+        d_data->boundingRect = data.d_data->boundingRect;
+        d_data->boundingRectValid = data.d_data->boundingRectValid;
+    }
+    return *this;
+}
+
+/*!
+  \return Pointer to a copy (virtual copy constructor)
+
+  The copy maps the files again, but shares the pages with
+  this object. The bounding rectangle is taken over.
+*/
+QwtData *QwtMappedFileData::copy() const
+{
+    QwtMappedFileData *data;
+    if ( d_data->interleaved )
+    {
+        data = new QwtMappedFileData(d_data->xFile.fileName(),
+            d_data->valueType, d_data->offset);
+    }
+    else
+    {
+        data = new QwtMappedFileData(d_data->xFile.fileName(),
+            d_data->yFile.fileName(), d_data->valueType, d_data->offset);
+    }
+
+    data->d_data->boundingRect = d_data->boundingRect;
+    data->d_data->boundingRectValid = d_data->boundingRectValid;
+
+    return data;
+}
+
+void QwtMappedFileData::map()
+{
+    const size_t valueSize = qwtValueSize(d_data->valueType);
+
+    size_t xCount = 0;
+    d_data->xValues = qwtMapFile(d_data->xFile,
+        d_data->offset, valueSize, xCount);
+
+    if ( d_data->interleaved )
+    {
+        if ( d_data->xValues )
+            d_data->yValues = d_data->xValues + valueSize;
+
+        d_data->stride = 2;
+        d_data->size = xCount / 2;
+    }
+    else
+    {
+        size_t yCount = 0;
+        d_data->yValues = qwtMapFile(d_data->yFile,
+            d_data->offset, valueSize, yCount);
+
+        d_data->stride = 1;
+        d_data->size = qwtMin(xCount, yCount);
+    }
+
+    if ( d_data->size == 0 )
+        unmap();
+
+    d_data->boundingRectValid = false;
+}
+
+void QwtMappedFileData::unmap()
+{
+    // closing a file also unmaps it
+    d_data->xFile.close();
+    d_data->yFile.close();
+
+    d_data->xValues = nullptr;
+    d_data->yValues = nullptr;
+    d_data->size = 0;
+    d_data->boundingRectValid = false;
+}
+
+/*!
+  \return true, when the files could be mapped and contain
+          at least one point
+*/
+bool QwtMappedFileData::isValid() const
+{
+    return d_data->size > 0;
+}
+
+//! \return true, when x and y values are stored in a single file
+bool QwtMappedFileData::isInterleaved() const
+{
+    return d_data->interleaved;
+}
+
+//! \return Type of the values
+QwtMappedFileData::ValueType QwtMappedFileData::valueType() const
+{
+    return d_data->valueType;
+}
+
+//! \return Number of bytes, that are skipped at the beginning of the files
+qint64 QwtMappedFileData::offset() const
+{
+    return d_data->offset;
+}
+
+//! \return Name of the file with the x values
+QString QwtMappedFileData::xFileName() const
+{
+    return d_data->xFile.fileName();
+}
+
+/*!
+  \return Name of the file with the y values, or the name of
+          the single file for interleaved data.
+*/
+QString QwtMappedFileData::yFileName() const
+{
+    if ( d_data->interleaved )
+        return d_data->xFile.fileName();
+
+    return d_data->yFile.fileName();
+}
+
+//! \return Number of points
+size_t QwtMappedFileData::size() const
+{
+    return d_data->size;
+}
+
+/*!
+  Return the x value of data point i
+
+  \param i Index
+  \return x X value of data point i
+*/
+double QwtMappedFileData::x(size_t i) const
+{
+    return d_data->xValue(i);
+}
+
+/*!
+  Return the y value of data point i
+
+  \param i Index
+  \return y Y value of data point i
+*/
+double QwtMappedFileData::y(size_t i) const
+{
+    return d_data->yValue(i);
+}
+
+/*!
+  Direct access to the mapped memory
+
+  Only files of doubles can be accessed directly, for floats
+  the values are converted by copyData().
+
+  \sa QwtData::rawData()
+*/
+bool QwtMappedFileData::rawData(size_t from, const double **x,
+    const double **y, size_t *stride) const
+{
+    if ( d_data->valueType != Double || d_data->size == 0 )
+        return false;
+
+    *x = reinterpret_cast<const double *>(d_data->xValues)
+        + from * d_data->stride;
+    *y = reinterpret_cast<const double *>(d_data->yValues)
+        + from * d_data->stride;
+    *stride = d_data->stride;
+
+    return true;
+}
+
+//! \sa QwtData::copyData()
+void QwtMappedFileData::copyData(size_t from, size_t size,
+    double *x, double *y) const
+{
+    if ( d_data->valueType == Float )
+    {
+        const size_t stride = d_data->stride;
+        const float *xValues =
+            reinterpret_cast<const float *>(d_data->xValues) + from * stride;
+        const float *yValues =
+            reinterpret_cast<const float *>(d_data->yValues) + from * stride;
+
+        for ( size_t i = 0; i < size; i++ )
+        {
+            x[i] = xValues[i * stride];
+            y[i] = yValues[i * stride];
+        }
+    }
+    else
+    {
+        QwtData::copyData(from, size, x, y);
+    }
+}
+
+/*!
+  \brief Assign the bounding rectangle
+
+  Calculating the bounding rectangle needs to read all values
+  of the files. When the rectangle is known in advance, f.e. from
+  a header of the file, it can be assigned to avoid the scan.
+
+  \param rect Bounding rectangle of all points
+  \sa boundingRect()
+*/
+void QwtMappedFileData::setBoundingRect(const QwtDoubleRect &rect)
+{
+    d_data->boundingRect = rect;
+    d_data->boundingRectValid = true;
+}
+
+/*!
+  Returns the bounding rectangle of the data.
+
+  The rectangle is calculated only once - or assigned with
+  setBoundingRect() - and cached.
+
+  \sa setBoundingRect()
+*/
+QwtDoubleRect QwtMappedFileData::boundingRect() const
+{
+    if ( d_data->boundingRectValid )
+        return d_data->boundingRect;
+
+    const double *x;
+    const double *y;
+    size_t stride;
+
+    if ( d_data->size == 0 )
+    {
+        d_data->boundingRect = QwtDoubleRect(1.0, 1.0, -2.0, -2.0); // invalid
+    }
+    else if ( rawData(0, &x, &y, &stride) )
+    {
+        d_data->boundingRect = qwtBoundingRect(x, y, d_data->size, stride);
+    }
+    else
+    {
+        double xBuffer[qwtChunkSize];
+        double yBuffer[qwtChunkSize];
+
+        double minX = 0.0, maxX = 0.0, minY = 0.0, maxY = 0.0;
+
+        for ( size_t from = 0; from < d_data->size; from += qwtChunkSize )
+        {
+            const size_t n = qwtMin(qwtChunkSize, d_data->size - from);
+            copyData(from, n, xBuffer, yBuffer);
+
+            const QwtDoubleRect r = qwtBoundingRect(xBuffer, yBuffer, n);
+            if ( from == 0 )
+            {
+                minX = r.left();
+                maxX = r.right();
+                minY = r.top();
+                maxY = r.bottom();
+            }
+            else
+            {
+                minX = qwtMin(minX, r.left());
+                maxX = qwtMax(maxX, r.right());
+                minY = qwtMin(minY, r.top());
+                maxY = qwtMax(maxY, r.bottom());
+            }
+        }
+
+        d_data->boundingRect =
+            QwtDoubleRect(minX, minY, maxX - minX, maxY - minY);
+    }
+
+    d_data->boundingRectValid = true;
+    return d_data->boundingRect;
+}
@@ -0,0 +1,98 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_MAPPED_FILE_DATA_H
+#define QWT_MAPPED_FILE_DATA_H 1
+
+#include "qwt_global.h"
+#include "qwt_data.h"
+
+class QString;
+
+/*!
+  \brief Data class for binary files, that are mapped into memory
+
+  QwtMappedFileData maps raw binary files read-only into the address
+  space of the process. No values are loaded or copied in advance:
+  the operating system pages in only the parts of the files, that are
+  accessed, what makes it possible to display series of several GB.
+
+  The files are expected to contain values of valueType() in native
+  byte order, starting at a byte offset. The series can be stored in
+  two files - one for the x and one for the y values - or interleaved
+  ( x0, y0, x1, y1, ... ) in a single file.
+
+  \verbatim
+QwtMappedFileData data("run42.x", "run42.y", QwtMappedFileData::Float);
+if ( data.isValid() )
+    curve->setData(data);
+\endverbatim
+
+  For files of doubles rawData() gives direct access to the mapped
+  memory. Floats are converted by copyData(), what QwtPlotCurve does
+  for blocks of a limited number of points, so that no copy of the
+  complete series is needed. The bounding rectangle has to scan all values once, but it is
+  cached. When it is known in advance it can be assigned
+  with setBoundingRect() to avoid the scan.
+
+  \warning The files must not be modified or truncated, while they are
+           mapped.
+*/
+class QWT_EXPORT QwtMappedFileData: public QwtData
+{
+public:
+    //! Type of the values stored in the files
+    enum ValueType
+    {
+        Double,
+        Float
+    };
+
+    QwtMappedFileData(const QString &xFileName, const QString &yFileName,
+        ValueType = Double, qint64 offset = 0);
+    QwtMappedFileData(const QString &fileName,
+        ValueType = Double, qint64 offset = 0);
+
+    virtual ~QwtMappedFileData();
+
+    QwtMappedFileData &operator=(const QwtMappedFileData &);
+    virtual QwtData *copy() const;
+
+    bool isValid() const;
+    bool isInterleaved() const;
+
+    ValueType valueType() const;
+    qint64 offset() const;
+
+    QString xFileName() const;
+    QString yFileName() const;
+
+    virtual size_t size() const;
+    virtual double x(size_t i) const;
+    virtual double y(size_t i) const;
+
+    virtual bool rawData(size_t from, const double **x, const double **y,
+        size_t *stride) const;
+    virtual void copyData(size_t from, size_t size,
+        double *x, double *y) const;
+
+    void setBoundingRect(const QwtDoubleRect &);
+    virtual QwtDoubleRect boundingRect() const;
+
+private:
+    QwtMappedFileData(const QwtMappedFileData &);
+
+    void map();
+    void unmap();
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+#endif
@@ -11,6 +11,12 @@
 
 #include "qwt_math.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#define QWT_MATH_SSE2 1
+#include <emmintrin.h>
+#endif
+
 /*!
   \brief Find the smallest value in an array
   \param array Pointer to an array
@@ -45,3 +51,151 @@ double qwtGetMax(const double *array, int size)
 
     return rv;
 }
+
+/*!
+  \brief Find the smallest and the largest value in an array
+
+  The array is scanned with SSE2 instructions, when available.
+  NaN values are ignored, unless the first value is NaN.
+
+  \param array Pointer to an array
+  \param size Array size
+  \param min Returns the smallest value
+  \param max Returns the largest value
+
+  \return false, when the array is empty
+*/
+bool qwtGetMinMax(const double *array, size_t size, 
+    double &min, double &max)
+{
+    if ( size == 0 )
+        return false;
+
+    size_t i = 1;
+    min = max = array[0];
+
+#if QWT_MATH_SSE2
+    if ( size >= 4 )
+    {
+        // 2 independent accumulators of 2 doubles each
+
+        __m128d min0 = _mm_set1_pd(array[0]);
+        __m128d max0 = min0;
+        __m128d min1 = min0;
+        __m128d max1 = min0;
+
+        for ( i = 0; i + 4 <= size; i += 4 )
+        {
+            const __m128d v0 = _mm_loadu_pd(array + i);
+            const __m128d v1 = _mm_loadu_pd(array + i + 2);
+
+            // operands in this order to skip NaN values
+            min0 = _mm_min_pd(v0, min0);
+            max0 = _mm_max_pd(v0, max0);
+            min1 = _mm_min_pd(v1, min1);
+            max1 = _mm_max_pd(v1, max1);
+        }
+
+        double lo[2], hi[2];
+        _mm_storeu_pd(lo, _mm_min_pd(min0, min1));
+        _mm_storeu_pd(hi, _mm_max_pd(max0, max1));
+
+        min = qwtMin(lo[0], lo[1]);
+        max = qwtMax(hi[0], hi[1]);
+    }
+#endif
+
+    for ( ; i < size; i++ )
+    {
+        const double v = array[i];
+        if ( v < min )
+            min = v;
+        if ( v > max )
+            max = v;
+    }
+
+    return true;
+}
+
+/*!
+  \brief Calculate the bounding rectangle of a series of points
+
+  \param x Pointer to the first x value
+  \param y Pointer to the first y value
+  \param size Number of points
+  \param stride Distance ( in doubles ) between 2 consecutive values.
+                Points stored as pairs of x and y values ( QPolygonF )
+                have a stride of 2.
+
+  \return Bounding rectangle, an invalid rectangle for size == 0
+*/
+QwtDoubleRect qwtBoundingRect(const double *x, const double *y,
+    size_t size, size_t stride)
+{
+    if ( size == 0 )
+        return QwtDoubleRect(1.0, 1.0, -2.0, -2.0); // invalid
+
+    double minX, maxX, minY, maxY;
+
+    if ( stride == 1 )
+    {
+        qwtGetMinMax(x, size, minX, maxX);
+        qwtGetMinMax(y, size, minY, maxY);
+
+        return QwtDoubleRect(minX, minY, maxX - minX, maxY - minY);
+    }
+
+    minX = maxX = x[0];
+    minY = maxY = y[0];
+
+    size_t i = 1;
+
+#if QWT_MATH_SSE2
+    if ( stride == 2 && y == x + 1 && size >= 2 )
+    {
+        // interleaved points: one register holds x and y of a point
+
+        __m128d min0 = _mm_loadu_pd(x);
+        __m128d max0 = min0;
+        __m128d min1 = min0;
+        __m128d max1 = min0;
+
+        for ( i = 0; i + 2 <= size; i += 2 )
+        {
+            const __m128d p0 = _mm_loadu_pd(x + 2 * i);
+            const __m128d p1 = _mm_loadu_pd(x + 2 * i + 2);
+
+            min0 = _mm_min_pd(p0, min0);
+            max0 = _mm_max_pd(p0, max0);
+            min1 = _mm_min_pd(p1, min1);
+            max1 = _mm_max_pd(p1, max1);
+        }
+
+        double lo[2], hi[2];
+        _mm_storeu_pd(lo, _mm_min_pd(min0, min1));
+        _mm_storeu_pd(hi, _mm_max_pd(max0, max1));
+
+        minX = lo[0];
+        minY = lo[1];
+        maxX = hi[0];
+        maxY = hi[1];
+    }
+#endif
+
+    for ( ; i < size; i++ )
+    {
+        const double xv = x[i * stride];
+        if ( xv < minX )
+            minX = xv;
+        if ( xv > maxX )
+            maxX = xv;
+
+        const double yv = y[i * stride];
+        if ( yv < minY )
+            minY = yv;
+        if ( yv > maxY )
+            maxY = yv;
+    }
+
+    return QwtDoubleRect(minX, minY, maxX - minX, maxY - minY);
+}
@@ -100,6 +100,11 @@
 QWT_EXPORT double qwtGetMin(const double *array, int size);
 QWT_EXPORT double qwtGetMax(const double *array, int size);
 
+QWT_EXPORT bool qwtGetMinMax(const double *array, size_t size,
+    double &min, double &max);
+QWT_EXPORT QwtDoubleRect qwtBoundingRect(const double *x, const double *y,
+    size_t size, size_t stride = 1);
+
 
 //! Return the sign 
 inline int qwtSign(double x)
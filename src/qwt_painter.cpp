@@ -16,6 +16,7 @@
 #include <qpalette.h>
 #include <qpaintdevice.h>
 #include <qpixmap.h>
+#include <qimage.h>
 #include <qstyle.h>
 #include <qtextdocument.h>
 #include <qabstracttextdocumentlayout.h>
@@ -27,15 +28,107 @@
 #include "qwt_color_map.h"
 #include "qwt_scale_map.h"
 #include "qwt_painter.h"
+#include "qwt_painter_context.h"
+
+/*
+  The raster paint engine seems to use some algo with O(n*n).
+  ( Qt 4.3 is better than Qt 4.2, but remains unacceptable)
+  To work around this problem, we have to split the polyline into
+  smaller pieces.
+ */
+template <class Point>
+static void qwtDrawPolyline(QPainter *painter,
+    const Point *points, int numPoints)
+{
+    bool doSplit = false;
+
+    const QPaintEngine *pe = painter->paintEngine();
+    if ( pe && pe->type() == QPaintEngine::Raster &&
+        painter->pen().width() >= 2 )
+    {
+        doSplit = true;
+    }
+
+    if ( doSplit )
+    {
+        const int splitSize = 20;
+        for ( int i = 0; i < numPoints; i += splitSize )
+        {
+            const int n = qwtMin(splitSize + 1, numPoints - i);
+            painter->drawPolyline(points + i, n);
+        }
+    }
+    else
+        painter->drawPolyline(points, numPoints);
+}
+
+/*
+  Points, that are painted with a solid, aliased pen of one pixel,
+  can be rasterized into an image, that is drawn at once.
+ */
+static bool qwtCanRasterizePoints(const QPainter *painter)
+{
+    if ( !QwtPainter::metricsMap().isIdentity() )
+        return false;
+
+    const QPaintEngine *pe = painter->paintEngine();
+    if ( pe == nullptr || pe->type() != QPaintEngine::Raster )
+        return false;
 
-QwtMetricsMap QwtPainter::d_metricsMap;
+    if ( painter->testRenderHint(QPainter::Antialiasing) )
+        return false;
 
-#if defined(Q_WS_X11)
-bool QwtPainter::d_deviceClipping = true;
-#else
-bool QwtPainter::d_deviceClipping = false;
+    if ( painter->worldTransform().type() > QTransform::TxTranslate )
+        return false;
+
+#if QT_VERSION >= 0x050600
+    // on high dpi devices a point covers more than one pixel
+    if ( painter->device() && painter->device()->devicePixelRatioF() != 1.0 )
+        return false;
 #endif
 
+    const QPen pen = painter->pen();
+    return pen.style() == Qt::SolidLine && pen.widthF() <= 1.0
+        && pen.brush().style() == Qt::SolidPattern;
+}
+
+/*
+  Set the pixels of the points, that are inside of rect. The points
+  are translated by offset, rect is in the coordinates of the image.
+ */
+static void qwtRasterizePoints(QImage &image, const QRect &rect,
+    const QPoint &offset, const QPointF *points, int numPoints, QRgb rgb)
+{
+    if ( rect.isEmpty() )
+        return;
+
+    uchar *bits = image.bits();
+    const int bytesPerLine = image.bytesPerLine();
+
+    const double x1 = rect.left() - 0.5;
+    const double x2 = rect.right() + 0.5;
+    const double y1 = rect.top() - 0.5;
+    const double y2 = rect.bottom() + 0.5;
+
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        const double x = points[i].x() + offset.x();
+        const double y = points[i].y() + offset.y();
+
+        // also sorts out NaNs
+        if ( x > x1 && x < x2 && y > y1 && y < y2 )
+        {
+            QRgb *line = reinterpret_cast<QRgb *>(
+                bits + qRound(y) * bytesPerLine);
+            line[qRound(x)] = rgb;
+        }
+    }
+}
+
+// context of all threads, that have no context of their own
+static QwtPainterContext qwtDefaultContext;
+static thread_local QwtPainterContext *qwtContext = nullptr;
+
 static inline bool isClippingNeeded(const QPainter *painter, QRect &clipRect)
 {
     bool doClipping = false;
@@ -72,15 +165,57 @@ static inline bool isClippingNeeded(const QPainter *painter, QRect &clipRect)
 }
 
 /*!
-  \brief En/Disable device clipping.
+  \brief Install a context for the calling thread
+
+  All QwtPainter operations of the calling thread use the
+  metrics map and device clipping of context, until another
+  context has been installed. The context is not copied and
+  has to stay alive, until it has been uninstalled.
+
+  \param context Context, or nullptr to use the default context,
+                 that is shared between all threads
+  \return Previous context of the calling thread, or nullptr,
+          when it has used the default context
+
+  \sa context(), QwtPainterContext
+*/
+QwtPainterContext *QwtPainter::setContext(QwtPainterContext *context)
+{
+    QwtPainterContext *previous = qwtContext;
+    qwtContext = context;
+
+    return previous;
+}
+
+/*!
+  \return Context of the calling thread
+  \sa setContext()
+*/
+QwtPainterContext *QwtPainter::context()
+{
+    return qwtContext ? qwtContext : &qwtDefaultContext;
+}
+
+/*!
+  \brief En/Disable device clipping for the current context
 
   On X11 the default for device clipping is enabled,
   otherwise it is disabled.
-  \sa QwtPainter::deviceClipping()
+  \sa QwtPainter::deviceClipping(), setContext()
 */
 void QwtPainter::setDeviceClipping(bool enable)
 {
-    d_deviceClipping = enable;
+    context()->setDeviceClipping(enable);
+}
+
+/*!
+  Returns whether device clipping is enabled for the current context.
+  On X11 the default is enabled, otherwise it is disabled.
+  \sa QwtPainter::setDeviceClipping()
+*/
+bool QwtPainter::deviceClipping()
+{
+    return context()->deviceClipping();
 }
 
 /*!
@@ -89,13 +224,9 @@ void QwtPainter::setDeviceClipping(bool enable)
 */
 const QRect &QwtPainter::deviceClipRect()
 {
-    static QRect clip;
+    static const QRect clip(QPoint(QWT_COORD_MIN, QWT_COORD_MIN),
+        QPoint(QWT_COORD_MAX, QWT_COORD_MAX));
 
-    if ( !clip.isValid() )
-    {
-        clip.setCoords(QWT_COORD_MIN, QWT_COORD_MIN,
-            QWT_COORD_MAX, QWT_COORD_MAX);
-    }
     return clip;
 }
 
@@ -110,7 +241,7 @@ const QRect &QwtPainter::deviceClipRect()
 void QwtPainter::setMetricsMap(const QPaintDevice *layout,
     const QPaintDevice *device)
 {
-    d_metricsMap.setMetrics(layout, device);
+    context()->setMetricsMap(layout, device);
 }
 
 /*!
@@ -119,7 +250,7 @@ void QwtPainter::setMetricsMap(const QPaintDevice *layout,
 */
 void QwtPainter::setMetricsMap(const QwtMetricsMap &map)
 {
-    d_metricsMap = map;
+    context()->setMetricsMap(map);
 }
 
 /*!
@@ -128,15 +259,15 @@ void QwtPainter::setMetricsMap(const QwtMetricsMap &map)
 */
 void QwtPainter::resetMetricsMap()
 {
-    d_metricsMap = QwtMetricsMap();
+    context()->setMetricsMap(QwtMetricsMap());
 }
 
 /*!
-  \return Metrics map
+  \return Metrics map of the current context
 */
 const QwtMetricsMap &QwtPainter::metricsMap()
 {
-    return d_metricsMap;
+    return context()->metricsMap();
 }
 
 /*!
@@ -144,7 +275,7 @@ const QwtMetricsMap &QwtPainter::metricsMap()
 */
 void QwtPainter::setClipRect(QPainter *painter, const QRect &rect)
 {
-    painter->setClipRect(d_metricsMap.layoutToDevice(rect, painter));
+    painter->setClipRect(metricsMap().layoutToDevice(rect, painter));
 }
 
 /*!
@@ -160,7 +291,7 @@ void QwtPainter::drawRect(QPainter *painter, int x, int y, int w, int h)
 */
 void QwtPainter::drawRect(QPainter *painter, const QRect &rect)
 {
-    const QRect r = d_metricsMap.layoutToDevice(rect, painter);
+    const QRect r = metricsMap().layoutToDevice(rect, painter);
 
     QRect clipRect;
     const bool deviceClipping = isClippingNeeded(painter, clipRect);
@@ -222,7 +353,7 @@ void QwtPainter::fillRect(QPainter *painter,
     if ( painter->hasClipping() )
         clipRect &= painter->clipRegion().boundingRect();
 
-    QRect r = d_metricsMap.layoutToDevice(rect, painter);
+    QRect r = metricsMap().layoutToDevice(rect, painter);
     if ( deviceClipping )
         r = r.intersected(clipRect);
 
@@ -236,7 +367,7 @@ void QwtPainter::fillRect(QPainter *painter,
 void QwtPainter::drawPie(QPainter *painter, const QRect &rect,
     int a, int alen)
 {
-    const QRect r = d_metricsMap.layoutToDevice(rect, painter);
+    const QRect r = metricsMap().layoutToDevice(rect, painter);
 
     QRect clipRect;
     const bool deviceClipping = isClippingNeeded(painter, clipRect);
@@ -252,7 +383,7 @@ void QwtPainter::drawPie(QPainter *painter, const QRect &rect,
 // modified by Ion Vasilief in order to fix not centered ellipse symbols
 void QwtPainter::drawEllipse(QPainter *painter, const QRect &rect)
 {
-    QRect r = d_metricsMap.layoutToDevice(rect, painter);
+    QRect r = metricsMap().layoutToDevice(rect, painter);
 
     QRect clipRect;
     const bool deviceClipping = isClippingNeeded(painter, clipRect);
@@ -278,7 +409,7 @@ void QwtPainter::drawText(QPainter *painter, int x, int y,
 void QwtPainter::drawText(QPainter *painter, const QPoint &pos,
         const QString &text)
 {
-    const QPoint p = d_metricsMap.layoutToDevice(pos, painter);
+    const QPoint p = metricsMap().layoutToDevice(pos, painter);
 
     QRect clipRect;
     const bool deviceClipping = isClippingNeeded(painter, clipRect);
@@ -304,7 +435,7 @@ void QwtPainter::drawText(QPainter *painter, int x, int y, int w, int h,
 void QwtPainter::drawText(QPainter *painter, const QRect &rect,
         int flags, const QString &text)
 {
-    QRect textRect = d_metricsMap.layoutToDevice(rect, painter);
+    QRect textRect = metricsMap().layoutToDevice(rect, painter);
     painter->drawText(textRect, flags, text);
 }
 
@@ -316,7 +447,7 @@ void QwtPainter::drawText(QPainter *painter, const QRect &rect,
 void QwtPainter::drawSimpleRichText(QPainter *painter, const QRect &rect,
     int flags, QTextDocument &text)
 {
-    const QRect scaledRect = d_metricsMap.layoutToDevice(rect, painter);
+    const QRect scaledRect = metricsMap().layoutToDevice(rect, painter);
     text.setPageSize(QSize(scaledRect.width(), QWIDGETSIZE_MAX));
 
     QAbstractTextDocumentLayout* layout = text.documentLayout();
@@ -360,7 +491,7 @@ void QwtPainter::drawLine(QPainter *painter, int x1, int y1, int x2, int y2)
         return;
     }
 
-    if ( d_metricsMap.isIdentity() )
+    if ( metricsMap().isIdentity() )
     {
         {
             painter->drawLine(x1, y1, x2, y2);
@@ -368,8 +499,8 @@ void QwtPainter::drawLine(QPainter *painter, int x1, int y1, int x2, int y2)
         }
     }
 
-    const QPoint p1 = d_metricsMap.layoutToDevice(QPoint(x1, y1));
-    const QPoint p2 = d_metricsMap.layoutToDevice(QPoint(x2, y2));
+    const QPoint p1 = metricsMap().layoutToDevice(QPoint(x1, y1));
+    const QPoint p2 = metricsMap().layoutToDevice(QPoint(x2, y2));
 
     painter->drawLine(p1, p2);
 }
@@ -382,7 +513,7 @@ void QwtPainter::drawPolygon(QPainter *painter, const QwtPolygon &pa)
     QRect clipRect;
     const bool deviceClipping = isClippingNeeded(painter, clipRect);
 
-    QwtPolygon cpa = d_metricsMap.layoutToDevice(pa);
+    QwtPolygon cpa = metricsMap().layoutToDevice(pa);
     if ( deviceClipping )
     {
 #ifdef __GNUC__
@@ -400,7 +531,7 @@ void QwtPainter::drawPolygon(QPainter *painter, const QwtPolygonF &pa)
     QRect clipRect;
     const bool deviceClipping = isClippingNeeded(painter, clipRect);
 
-    QwtPolygonF cpa = d_metricsMap.layoutToDevice(pa);
+    QwtPolygonF cpa = metricsMap().layoutToDevice(pa);
     if ( deviceClipping )
     {
 #ifdef __GNUC__
@@ -412,85 +543,96 @@ void QwtPainter::drawPolygon(QPainter *painter, const QwtPolygonF &pa)
 
 /*!
     Wrapper for QPainter::drawPolyline()
+
+    When device clipping is enabled, the parts outside of the
+    clip rectangle are dropped by QwtClipper::clipPolyline().
 */
 void QwtPainter::drawPolyline(QPainter *painter, const QwtPolygon &pa)
 {
     QRect clipRect;
     const bool deviceClipping = isClippingNeeded(painter, clipRect);
 
-    QwtPolygon cpa = d_metricsMap.layoutToDevice(pa);
+    const QwtPolygon cpa = metricsMap().layoutToDevice(pa);
     if ( deviceClipping )
-        cpa = QwtClipper::clipPolygon(clipRect, cpa);
-
-    bool doSplit = false;
-
-    const QPaintEngine *pe = painter->paintEngine();
-    if ( pe && pe->type() == QPaintEngine::Raster &&
-        painter->pen().width() >= 2 )
     {
-        /*
-            The raster paint engine seems to use some algo with O(n*n).
-            ( Qt 4.3 is better than Qt 4.2, but remains unacceptable)
-            To work around this problem, we have to split the polygon into
-            smaller pieces.
-         */
-        doSplit = true;
-    }
+        // the buffers are reused for all polylines of a thread
+        static thread_local QwtPolygon clipped;
+        static thread_local QwtArray<int> runLengths;
 
-    if ( doSplit )
-    {
-        const int numPoints = cpa.size();
-        const QPoint *points = cpa.data();
+        QwtClipper::clipPolyline(clipRect, cpa, clipped, runLengths);
 
-        const int splitSize = 20;
-        for ( int i = 0; i < numPoints; i += splitSize )
+        const QPoint *points = clipped.constData();
+        for ( int i = 0; i < runLengths.size(); i++ )
         {
-            const int n = qwtMin(splitSize + 1, cpa.size() - i);
-            painter->drawPolyline(points + i, n);
+            qwtDrawPolyline(painter, points, runLengths[i]);
+            points += runLengths[i];
         }
     }
     else
-        painter->drawPolyline(cpa);
+    {
+        qwtDrawPolyline(painter, cpa.constData(), cpa.size());
+    }
 }
 
+/*!
+    Wrapper for QPainter::drawPolyline()
+
+    When device clipping is enabled, the parts outside of the
+    clip rectangle are dropped by QwtClipper::clipPolyline().
+*/
 void QwtPainter::drawPolyline(QPainter *painter, const QwtPolygonF &pa)
 {
     QRect clipRect;
     const bool deviceClipping = isClippingNeeded(painter, clipRect);
 
-    QwtPolygonF cpa = d_metricsMap.layoutToDevice(pa);
+    const QwtPolygonF cpa = metricsMap().layoutToDevice(pa);
     if ( deviceClipping )
-        cpa = QwtClipper::clipPolygonF(clipRect, cpa);
+    {
+        // the buffers are reused for all polylines of a thread
+        static thread_local QwtPolygonF clipped;
+        static thread_local QwtArray<int> runLengths;
 
-    bool doSplit = false;
+        QwtClipper::clipPolyline(clipRect, cpa, clipped, runLengths);
 
-    const QPaintEngine *pe = painter->paintEngine();
-    if ( pe && pe->type() == QPaintEngine::Raster &&
-        painter->pen().width() >= 2 )
+        const QPointF *points = clipped.constData();
+        for ( int i = 0; i < runLengths.size(); i++ )
+        {
+            qwtDrawPolyline(painter, points, runLengths[i]);
+            points += runLengths[i];
+        }
+    }
+    else
     {
-        /*
-            The raster paint engine seems to use some algo with O(n*n).
-            ( Qt 4.3 is better than Qt 4.2, but remains unacceptable)
-            To work around this problem, we have to split the polygon into
-            smaller pieces.
-         */
-        doSplit = true;
+        qwtDrawPolyline(painter, cpa.constData(), cpa.size());
     }
+}
 
-    if ( doSplit )
+/*!
+    Wrapper for QPainter::drawPolyline()
+
+    \param painter Painter
+    \param points Array of points
+    \param pointCount Number of points
+*/
+void QwtPainter::drawPolyline(QPainter *painter,
+    const QPointF *points, int pointCount)
+{
+    if ( pointCount <= 0 )
+        return;
+
+    QRect clipRect;
+    if ( !metricsMap().isIdentity() || isClippingNeeded(painter, clipRect) )
     {
-        const int numPoints = cpa.size();
-        const QPointF *points = cpa.data();
+        QwtPolygonF pa(pointCount);
+        for ( int i = 0; i < pointCount; i++ )
+            pa[i] = points[i];
 
-        const int splitSize = 20;
-        for ( int i = 0; i < numPoints; i += splitSize )
-        {
-            const int n = qwtMin(splitSize + 1, cpa.size() - i);
-            painter->drawPolyline(points + i, n);
-        }
+        drawPolyline(painter, pa);
     }
     else
-        painter->drawPolyline(cpa);
+    {
+        qwtDrawPolyline(painter, points, pointCount);
+    }
 }
 
 /*!
@@ -502,7 +644,7 @@ void QwtPainter::drawPoint(QPainter *painter, int x, int y)
     QRect clipRect;
     const bool deviceClipping = isClippingNeeded(painter, clipRect);
 
-    const QPoint pos = d_metricsMap.layoutToDevice(QPoint(x, y));
+    const QPoint pos = metricsMap().layoutToDevice(QPoint(x, y));
 
     if ( deviceClipping && !clipRect.contains(pos) )
         return;
@@ -519,7 +661,7 @@ void QwtPainter::drawPoint(QPainter *painter, double x, double y)
     QRect clipRect;
     const bool deviceClipping = isClippingNeeded(painter, clipRect);
 
-    const QPointF pos = d_metricsMap.layoutToDevice(QPointF(x, y));
+    const QPointF pos = metricsMap().layoutToDevice(QPointF(x, y));
 
     if ( deviceClipping && !clipRect.contains(pos.toPoint()) )
         return;
@@ -527,6 +669,99 @@ void QwtPainter::drawPoint(QPainter *painter, double x, double y)
     painter->drawPoint(pos);
 }
 
+/*!
+    \brief Draw many points
+
+    Wrapper for QPainter::drawPoints(). When the painter paints with a
+    solid, aliased pen of one pixel on a raster paint device without
+    a device pixel ratio, the points are rasterized into a transparent image, that is drawn with a single
+    QPainter::drawImage(). The paint device of the painter is never
+    written behind its back.
+
+    \param painter Painter
+    \param points Array of points
+    \param pointCount Number of points
+*/
+void QwtPainter::drawPoints(QPainter *painter,
+    const QPointF *points, int pointCount)
+{
+    if ( pointCount <= 0 )
+        return;
+
+    QRect clipRect;
+    const bool deviceClipping = isClippingNeeded(painter, clipRect);
+
+    if ( !qwtCanRasterizePoints(painter) )
+    {
+        if ( metricsMap().isIdentity() && !deviceClipping )
+        {
+            painter->drawPoints(points, pointCount);
+        }
+        else
+        {
+            for ( int i = 0; i < pointCount; i++ )
+                drawPoint(painter, points[i].x(), points[i].y());
+        }
+
+        return;
+    }
+
+    const QColor color = painter->pen().color();
+
+    const QTransform transform = painter->worldTransform();
+
+    QRect rect = painter->window().translated(
+        -qRound(transform.dx()), -qRound(transform.dy()));
+    if ( painter->hasClipping() )
+        rect &= painter->clipRegion().boundingRect();
+    if ( deviceClipping )
+        rect &= clipRect;
+
+    if ( rect.isEmpty() )
+        return;
+
+    // the image doesn't need to be larger than the points
+
+    double minX = rect.right() + 0.5;
+    double maxX = rect.left() - 0.5;
+    double minY = rect.bottom() + 0.5;
+    double maxY = rect.top() - 0.5;
+
+    for ( int i = 0; i < pointCount; i++ )
+    {
+        // comparisons with NaNs are always false
+        const QPointF &p = points[i];
+        if ( p.x() < minX )
+            minX = p.x();
+        if ( p.x() > maxX )
+            maxX = p.x();
+        if ( p.y() < minY )
+            minY = p.y();
+        if ( p.y() > maxY )
+            maxY = p.y();
+    }
+
+    minX = qwtMax(minX, double(rect.left()));
+    maxX = qwtMin(maxX, double(rect.right()));
+    minY = qwtMax(minY, double(rect.top()));
+    maxY = qwtMin(maxY, double(rect.bottom()));
+
+    if ( minX > maxX || minY > maxY )
+        return;
+
+    rect &= QRect(QPoint(qRound(minX), qRound(minY)),
+        QPoint(qRound(maxX), qRound(maxY)));
+
+    QImage image(rect.size(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(0);
+
+    // overwriting the pixels of duplicates blends each pixel only once
+    qwtRasterizePoints(image, image.rect(), -rect.topLeft(),
+        points, pointCount, qPremultiply(color.rgba()));
+
+    painter->drawImage(rect.topLeft(), image);
+}
+
 void QwtPainter::drawColoredArc(QPainter *painter, const QRect &rect,
     int peak, int arc, int interval, const QColor &c1, const QColor &c2)
 {
@@ -613,7 +848,7 @@ void QwtPainter::drawColorBar(QPainter *painter,
 
     QColor c;
 
-    const QRect devRect = d_metricsMap.layoutToDevice(rect);
+    const QRect devRect = metricsMap().layoutToDevice(rect);
 
     /*
       We paint to a pixmap first to have something scalable for printing
@@ -23,6 +23,7 @@ class QColor;
 class QWidget;
 class QwtScaleMap;
 class QwtColorMap;
+class QwtPainterContext;
 class QwtDoubleInterval;
 class QPalette;
 class QTextDocument;
@@ -52,11 +53,18 @@ class QTextDocument;
   implementation, QwtPainter adds scaling of these geometries.
   (Unfortunately QPainter::scale scales both types of paintings,
    so the objects of the first type would be scaled twice).
+
+  The metrics map and device clipping are stored in the
+  QwtPainterContext, that is current for the calling thread.
+  The static setters modify this context.
 */
 
 class QWT_EXPORT QwtPainter
 {
 public:
+    static QwtPainterContext *setContext(QwtPainterContext *);
+    static QwtPainterContext *context();
+
     static void setMetricsMap(const QPaintDevice *layout,
         const QPaintDevice *device);
     static void setMetricsMap(const QwtMetricsMap &);
@@ -96,8 +104,10 @@ public:
     static void drawPolygon(QPainter *, const QwtPolygonF &pa);
     static void drawPolyline(QPainter *, const QwtPolygon &pa);
     static void drawPolyline(QPainter *painter, const QwtPolygonF &pa);
+    static void drawPolyline(QPainter *, const QPointF *, int pointCount);
     static void drawPoint(QPainter *, int x, int y);
     static void drawPoint(QPainter *, double x, double y);
+    static void drawPoints(QPainter *, const QPointF *, int pointCount);
 
     static void drawRoundFrame(QPainter *, const QRect &, int width, const QPalette &, bool sunken);
     static void drawFocusRect(QPainter *, QWidget *);
@@ -112,9 +122,6 @@ public:
 private:
     static void drawColoredArc(QPainter *, const QRect &,
         int peak, int arc, int intervall, const QColor &c1, const QColor &c2);
-
-    static bool d_deviceClipping;
-    static QwtMetricsMap d_metricsMap;
 };
 
 //!  Wrapper for QPainter::drawLine()
@@ -124,14 +131,4 @@ inline void QwtPainter::drawLine(QPainter *painter,
     drawLine(painter, p1.x(), p1.y(), p2.x(), p2.y());
 }
 
-/*!
-  Returns whether device clipping is enabled. On X11 the default
-  is enabled, otherwise it is disabled.
-  \sa QwtPainter::setDeviceClipping()
-*/
-inline bool QwtPainter::deviceClipping()
-{
-    return d_deviceClipping;
-}
-
 #endif
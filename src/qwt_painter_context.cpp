@@ -0,0 +1,58 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_painter_context.h"
+
+/*!
+  \brief Constructor
+
+  The metrics map is initialized to the ratio 1:1. On X11
+  device clipping is enabled, otherwise it is disabled.
+*/
+QwtPainterContext::QwtPainterContext():
+#if defined(Q_WS_X11)
+    d_deviceClipping(true)
+#else
+    d_deviceClipping(false)
+#endif
+{
+}
+
+/*!
+  Scale all QwtPainter drawing operations using the ratio
+  of the resolutions of layout and device
+
+  \param layout Paint device, the layout has been calculated for
+  \param device Paint device, that is painted to
+
+  \sa metricsMap()
+*/
+void QwtPainterContext::setMetricsMap(const QPaintDevice *layout,
+    const QPaintDevice *device)
+{
+    d_metricsMap.setMetrics(layout, device);
+}
+
+/*!
+  Change the metrics map
+  \sa metricsMap()
+*/
+void QwtPainterContext::setMetricsMap(const QwtMetricsMap &map)
+{
+    d_metricsMap = map;
+}
+
+/*!
+  \brief En/Disable device clipping
+  \sa deviceClipping()
+*/
+void QwtPainterContext::setDeviceClipping(bool enable)
+{
+    d_deviceClipping = enable;
+}
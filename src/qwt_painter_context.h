@@ -0,0 +1,73 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_PAINTER_CONTEXT_H
+#define QWT_PAINTER_CONTEXT_H 1
+
+#include "qwt_global.h"
+#include "qwt_layout_metrics.h"
+
+class QPaintDevice;
+
+/*!
+  \brief State of the QwtPainter operations
+
+  QwtPainter scales its operations by a metrics map and clips them
+  to the coordinate system limits, when device clipping is enabled.
+  This state is stored in a context, that is current for a thread.
+
+  Each thread uses a default context, that is shared between all
+  threads, unless a context has been installed with
+  QwtPainter::setContext(). Code, that modifies the metrics map
+  like QwtPlot::print(), installs a context of its own. So renders
+  of different plots can run concurrently in different threads.
+
+  \verbatim
+QwtPainterContext context(*QwtPainter::context());
+QwtPainterContext *previous = QwtPainter::setContext(&context);
+
+QwtPainter::setMetricsMap(layoutDevice, paintDevice);
+// paint ...
+
+QwtPainter::setContext(previous);
+\endverbatim
+
+  \sa QwtPainter::setContext(), QwtPainter::context()
+*/
+class QWT_EXPORT QwtPainterContext
+{
+public:
+    QwtPainterContext();
+
+    void setMetricsMap(const QPaintDevice *layout,
+        const QPaintDevice *device);
+    void setMetricsMap(const QwtMetricsMap &);
+    const QwtMetricsMap &metricsMap() const;
+
+    void setDeviceClipping(bool);
+    bool deviceClipping() const;
+
+private:
+    QwtMetricsMap d_metricsMap;
+    bool d_deviceClipping;
+};
+
+//! \return Metrics map
+inline const QwtMetricsMap &QwtPainterContext::metricsMap() const
+{
+    return d_metricsMap;
+}
+
+//! \return true, when device clipping is enabled
+inline bool QwtPainterContext::deviceClipping() const
+{
+    return d_deviceClipping;
+}
+
+#endif
@@ -0,0 +1,108 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include <qrunnable.h>
+#include <qsemaphore.h>
+#include <qthreadpool.h>
+#include "qwt_math.h"
+#include "qwt_parallel.h"
+
+class QwtParallelTask: public QRunnable
+{
+public:
+    QwtParallelTask(const std::function<void(int)> &function,
+            int index, QSemaphore &done):
+        _function(function),
+        _index(index),
+        _done(done)
+    {
+        setAutoDelete(true);
+    }
+
+    virtual void run()
+    {
+        _function(_index);
+        _done.release();
+    }
+
+private:
+    const std::function<void(int)> &_function;
+    const int _index;
+    QSemaphore &_done;
+};
+
+/*!
+  \return Maximum number of threads of the global thread pool,
+          but at least 1
+*/
+int QwtParallel::threadCount()
+{
+    return qwtMax(QThreadPool::globalInstance()->maxThreadCount(), 1);
+}
+
+/*!
+  \brief Number of chunks for processing a series concurrently
+
+  \param size Number of elements
+  \param minChunkSize Minimum number of elements of a chunk,
+         that justifies the overhead of a task.
+
+  \return Number of chunks in the range [1, threadCount()]
+*/
+int QwtParallel::chunkCount(size_t size, size_t minChunkSize)
+{
+    if ( minChunkSize == 0 )
+        minChunkSize = 1;
+
+    const size_t numChunks = size / minChunkSize;
+    if ( numChunks <= 1 )
+        return 1;
+
+    return int(qwtMin(numChunks, size_t(threadCount())));
+}
+
+/*!
+  \brief Execute tasks concurrently
+
+  task is called with the indices 0 to numTasks - 1. The calls might
+  happen in any order and in different threads. run() returns,
+  when all calls have been finished.
+
+  \param numTasks Number of tasks
+  \param task Function, that executes a task
+*/
+void QwtParallel::run(int numTasks, const std::function<void(int)> &task)
+{
+    if ( numTasks <= 0 )
+        return;
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+
+    QSemaphore done;
+    int numStarted = 0;
+
+    for ( int i = 1; i < numTasks; i++ )
+    {
+        QwtParallelTask *runnable = new QwtParallelTask(task, i, done);
+        if ( pool->tryStart(runnable) )
+        {
+            numStarted++;
+        }
+        else
+        {
+            // no idle thread: better do it ourself, than waiting
+            delete runnable;
+            task(i);
+        }
+    }
+
+    task(0);
+
+    done.acquire(numStarted);
+}
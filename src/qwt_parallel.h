@@ -0,0 +1,43 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_PARALLEL_H
+#define QWT_PARALLEL_H 1
+
+#include <functional>
+#include "qwt_global.h"
+
+/*!
+  \brief Distribution of independent tasks to the global thread pool
+
+  QwtParallel::run() executes a number of tasks concurrently and
+  returns, when all of them are done. One of the tasks is always
+  executed in the calling thread. Tasks, that can't be started,
+  because all threads of QThreadPool::globalInstance() are busy,
+  are executed in the calling thread too. So it is safe to call
+  run() from a task itself.
+
+  \verbatim
+QwtParallel::run(numChunks, [&](int chunk)
+{
+    // process chunk
+});
+\endverbatim
+*/
+class QWT_EXPORT QwtParallel
+{
+public:
+    static int threadCount();
+
+    static int chunkCount(size_t size, size_t minChunkSize);
+
+    static void run(int numTasks, const std::function<void(int)> &task);
+};
+
+#endif
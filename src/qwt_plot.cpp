@@ -7,11 +7,15 @@
  * modify it under the terms of the Qwt License, Version 1.0
  *****************************************************************************/
 
+#include <atomic>
 #include <qpainter.h>
 #include <qpointer.h>
 #include <qpaintengine.h>
 #include <qapplication.h>
 #include <qevent.h>
+#include <qtimer.h>
+#include <qelapsedtimer.h>
+#include <qmutex.h>
 #include "qwt_plot.h"
 #include "qwt_plot_dict.h"
 #include "qwt_plot_layout.h"
@@ -21,6 +25,11 @@
 #include "qwt_legend.h"
 #include "qwt_dyngrid_layout.h"
 #include "qwt_plot_canvas.h"
+#include "qwt_plot_curve.h"
+#include "qwt_spatial_index.h"
+#include "qwt_parallel.h"
+#include "qwt_painter.h"
+#include "qwt_painter_context.h"
 
 class QwtPlot::PrivateData
 {
@@ -31,6 +40,26 @@ public:
     QwtPlotLayout *layout;
 
     bool autoReplot;
+
+    // deferred replots of autoRefresh()
+    bool deferredReplot;
+    double maxReplotRate;
+    QTimer *replotTimer;
+    QElapsedTimer lastReplot;
+
+    // areas of the canvas, that have been changed since the last replot
+    QRegion damagedRegion;
+    bool fullDamage;
+
+    bool parallelRendering;
+
+    // statistics of the last replot. The items might be painted
+    // by the thread pool, so all accesses are guarded by the mutex.
+    bool statisticsEnabled;
+    bool isRecording;
+    std::atomic<bool> isRecordingItems;
+    QwtReplotStatistics statistics;
+    mutable QMutex statisticsMutex;
 };
 
 /*!
@@ -57,6 +86,9 @@ QwtPlot::QwtPlot(const QwtText &title, QWidget *parent):
 //! Destructor
 QwtPlot::~QwtPlot()
 {
+    // the items might be painted by an asynchronous render
+    d_data->canvas->cancelRender();
+
     detachItems(QwtPlotItem::Rtti_PlotItem, autoDelete());
 
     delete d_data->layout;
@@ -76,6 +108,18 @@ void QwtPlot::initPlot(const QwtText &title)
 
     d_data->autoReplot = false;
 
+    d_data->deferredReplot = false;
+    d_data->maxReplotRate = 0.0;
+    d_data->fullDamage = true;
+    d_data->parallelRendering = false;
+    d_data->statisticsEnabled = false;
+    d_data->isRecording = false;
+    d_data->isRecordingItems = false;
+
+    d_data->replotTimer = new QTimer(this);
+    d_data->replotTimer->setSingleShot(true);
+    connect(d_data->replotTimer, SIGNAL(timeout()), SLOT(replot()));
+
     d_data->lblTitle = new QwtTextLabel(title, this);
     d_data->lblTitle->setFont(QFont(fontInfo().family(), 14, QFont::Bold));
 
@@ -119,11 +163,228 @@ bool QwtPlot::event(QEvent *e)
     return ok;
 }
 
-//! Replots the plot if QwtPlot::autoReplot() is \c true.
+/*!
+  Replots the plot if QwtPlot::autoReplot() is \c true.
+
+  When deferredReplot() is enabled, the replot is scheduled for the
+  next turn of the event loop, so that all changes until then result
+  in a single replot.
+
+  \sa setDeferredReplot(), setMaxReplotRate(), flushReplot()
+*/
 void QwtPlot::autoRefresh()
 {
-    if (d_data->autoReplot)
+    if ( !d_data->autoReplot )
+        return;
+
+    if ( !d_data->deferredReplot )
+    {
         replot();
+        return;
+    }
+
+    if ( d_data->replotTimer->isActive() )
+        return;
+
+    int delay = 0;
+    if ( d_data->maxReplotRate > 0.0 && d_data->lastReplot.isValid() )
+    {
+        const qint64 interval = qRound64(1000.0 / d_data->maxReplotRate);
+        const qint64 elapsed = d_data->lastReplot.elapsed();
+
+        if ( elapsed < interval )
+            delay = int(interval - elapsed);
+    }
+
+    d_data->replotTimer->start(delay);
+}
+
+/*!
+  \brief Replot immediately, when a deferred replot is pending
+
+  Applications, that need the result of the changes synchronously -
+  f.e. before grabbing the plot - can call flushReplot() instead
+  of waiting for the event loop. Without a pending replot nothing
+  happens.
+
+  \sa isReplotPending(), setDeferredReplot()
+*/
+void QwtPlot::flushReplot()
+{
+    if ( !d_data->replotTimer->isActive() )
+        return;
+
+    d_data->replotTimer->stop();
+    replot();
+}
+
+/*!
+  \return true, when a deferred replot has been scheduled,
+          but not yet been executed
+  \sa flushReplot(), setDeferredReplot()
+*/
+bool QwtPlot::isReplotPending() const
+{
+    return d_data->replotTimer->isActive();
+}
+
+/*!
+  \brief En/Disable deferred replots
+
+  With deferred replots autoRefresh() doesn't replot synchronously.
+  Instead all change notifications of the plot items until the
+  event loop is entered again are merged into a single replot.
+  Explicit calls of replot() are not affected.
+
+  The default setting is disabled.
+
+  \param on On/Off
+  \sa deferredReplot(), setMaxReplotRate(), flushReplot()
+*/
+void QwtPlot::setDeferredReplot(bool on)
+{
+    d_data->deferredReplot = on;
+
+    if ( !on )
+        flushReplot();
+}
+
+/*!
+  \return true, when deferred replots are enabled
+  \sa setDeferredReplot()
+*/
+bool QwtPlot::deferredReplot() const
+{
+    return d_data->deferredReplot;
+}
+
+/*!
+  \brief En/Disable parallel rendering of the items
+
+  When parallel rendering is enabled, drawItems() paints each item
+  into an image of its own, using the threads of QwtParallel,
+  and composites the images in z order. This is done for raster
+  paint devices without scaling or rotation only, otherwise the
+  items are painted one after the other.
+
+  As all items are painted at the same time, they need to be
+  independent from each other. Each item needs an image of the size
+  of the canvas temporarily.
+
+  The default setting is false.
+
+  \sa parallelRendering(), drawItems(), QwtParallel
+*/
+void QwtPlot::setParallelRendering(bool on)
+{
+    d_data->parallelRendering = on;
+}
+
+/*!
+  \return true, when parallel rendering is enabled
+  \sa setParallelRendering()
+*/
+bool QwtPlot::parallelRendering() const
+{
+    return d_data->parallelRendering;
+}
+
+/*!
+  \brief En/Disable statistics of the replots
+
+  When statistics are enabled, replot() measures the time of each
+  stage and of painting each item, and emits statisticsUpdated().
+  Items, that are painted asynchronously after replot() has returned
+  ( see QwtPlotCanvas::PaintAsynchronous ), are not included in the
+  statistics of the replot.
+
+  The default setting is false.
+
+  \sa statisticsEnabled(), replotStatistics(), QwtReplotStatistics
+*/
+void QwtPlot::setStatisticsEnabled(bool on)
+{
+    d_data->statisticsEnabled = on;
+}
+
+/*!
+  \return true, when statistics of the replots are enabled
+  \sa setStatisticsEnabled()
+*/
+bool QwtPlot::statisticsEnabled() const
+{
+    return d_data->statisticsEnabled;
+}
+
+/*!
+  \return Copy of the statistics of the last replot, that has
+          been done with enabled statistics
+  \sa setStatisticsEnabled(), statisticsUpdated()
+*/
+QwtReplotStatistics QwtPlot::replotStatistics() const
+{
+    QMutexLocker locker(&d_data->statisticsMutex);
+    return d_data->statistics;
+}
+
+/*!
+  \brief Add an area of the canvas, that needs to be repainted
+
+  The damaged areas are accumulated until the next replot(). When
+  the canvas has the QwtPlotCanvas::PaintDamaged attribute, only
+  the union of them is repainted.
+  QwtPlotItem::itemChanged() adds the areas of the old and the new
+  bounding rectangle of the item ( see QwtPlotItem::damageRect() ).
+
+  \param rect Rectangle in canvas coordinates. An invalid rectangle
+              damages the complete canvas.
+
+  \sa damagedRegion(), QwtPlotCanvas::PaintDamaged
+*/
+void QwtPlot::addDamagedRect(const QRect &rect)
+{
+    if ( !rect.isValid() )
+        d_data->fullDamage = true;
+    else if ( !d_data->fullDamage )
+        d_data->damagedRegion += rect;
+}
+
+/*!
+  \return Areas of the canvas, that have been damaged since the
+          last replot. When the complete canvas is damaged, the
+          contents rectangle of the canvas is returned.
+  \sa addDamagedRect()
+*/
+QRegion QwtPlot::damagedRegion() const
+{
+    if ( d_data->fullDamage )
+        return QRegion(d_data->canvas->contentsRect());
+
+    return d_data->damagedRegion;
+}
+
+/*!
+  \brief Limit the rate of deferred replots
+
+  A deferred replot is delayed, until 1.0 / framesPerSecond
+  seconds have passed since the previous replot.
+  A rate <= 0.0 means unlimited, what is the default.
+
+  \param framesPerSecond Maximum number of replots per second
+  \sa maxReplotRate(), setDeferredReplot()
+*/
+void QwtPlot::setMaxReplotRate(double framesPerSecond)
+{
+    d_data->maxReplotRate = qwtMax(framesPerSecond, 0.0);
+}
+
+/*!
+  \return Maximum number of deferred replots per second
+  \sa setMaxReplotRate()
+*/
+double QwtPlot::maxReplotRate() const
+{
+    return d_data->maxReplotRate;
 }
 
 /*!
@@ -321,11 +582,56 @@ void QwtPlot::resizeEvent(QResizeEvent *e)
 */
 void QwtPlot::replot()
 {
+    // a pending deferred replot is done now
+    d_data->replotTimer->stop();
+    d_data->lastReplot.start();
+
+    /*
+      updateAxes() and the statistics access the items, what must
+      not happen, while they are painted by an asynchronous render.
+      It would be cancelled by the new render anyway.
+     */
+    if ( d_data->canvas->isRendering() )
+        d_data->canvas->cancelRender();
+
     bool doAutoReplot = autoReplot();
     setAutoReplot(false);
 
+    const bool record = d_data->statisticsEnabled;
+
+    QElapsedTimer replotTimer;
+    QElapsedTimer stageTimer;
+
+    if ( record )
+    {
+        // items, that are painted by an asynchronous render after
+        // replot() has returned, are not part of the statistics
+
+        const bool asynchronous = d_data->canvas->testPaintAttribute(
+            QwtPlotCanvas::PaintAsynchronous) &&
+            d_data->canvas->paintCache() != nullptr;
+
+        QMutexLocker locker(&d_data->statisticsMutex);
+
+        d_data->statistics.reset();
+        d_data->isRecording = true;
+        d_data->isRecordingItems = !asynchronous;
+
+        replotTimer.start();
+        stageTimer.start();
+    }
+
     updateAxes();
 
+    if ( record )
+    {
+        QMutexLocker locker(&d_data->statisticsMutex);
+
+        d_data->statistics.setStageTime(QwtReplotStatistics::UpdateAxes,
+            stageTimer.nsecsElapsed());
+        stageTimer.restart();
+    }
+
     /*
       Maybe the layout needs to be updated, because of changed
       axes labels. We need to process them here before painting
@@ -333,9 +639,52 @@ void QwtPlot::replot()
      */
     QApplication::sendPostedEvents(this, QEvent::LayoutRequest);
 
-    d_data->canvas->replot();
+    if ( record )
+    {
+        QMutexLocker locker(&d_data->statisticsMutex);
+
+        d_data->statistics.setStageTime(QwtReplotStatistics::PostedEvents,
+            stageTimer.nsecsElapsed());
+        stageTimer.restart();
+    }
+
+    /*
+      Without any damage something has been changed without notification,
+      what needs a complete repaint too.
+     */
+    if ( d_data->canvas->testPaintAttribute(QwtPlotCanvas::PaintDamaged)
+        && !d_data->fullDamage && !d_data->damagedRegion.isEmpty() )
+    {
+        d_data->canvas->replot(d_data->damagedRegion);
+    }
+    else
+    {
+        d_data->canvas->replot();
+    }
+
+    d_data->damagedRegion = QRegion();
+    d_data->fullDamage = false;
 
     setAutoReplot(doAutoReplot);
+
+    if ( record )
+    {
+        QwtReplotStatistics statistics;
+        {
+            QMutexLocker locker(&d_data->statisticsMutex);
+
+            d_data->statistics.setStageTime(QwtReplotStatistics::Canvas,
+                stageTimer.nsecsElapsed());
+            d_data->statistics.setTotalTime(replotTimer.nsecsElapsed());
+
+            d_data->isRecording = false;
+            d_data->isRecordingItems = false;
+
+            statistics = d_data->statistics;
+        }
+
+        emit statisticsUpdated(statistics);
+    }
 }
 
 /*!
@@ -344,8 +693,19 @@ void QwtPlot::replot()
 */
 void QwtPlot::updateLayout()
 {
+    QElapsedTimer timer;
+    if ( d_data->isRecording )
+        timer.start();
+
     d_data->layout->activate(this, contentsRect());
 
+    if ( d_data->isRecording )
+    {
+        QMutexLocker locker(&d_data->statisticsMutex);
+        d_data->statistics.addStageTime(
+            QwtReplotStatistics::LayoutActivate, timer.nsecsElapsed());
+    }
+
     //
     // resize and show the visible widgets
     //
@@ -465,10 +825,16 @@ void QwtPlot::updateTabOrder()
   Redraw the canvas.
   \param painter Painter used for drawing
 
+  Items with the QwtPlotItem::Overlay attribute are not painted,
+  as the canvas paints them on top of its cached contents.
+
   \warning drawCanvas calls drawItems what is also used
            for printing. Applications that like to add individual
            plot items better overload drawItems()
-  \sa drawItems()
+  \note With QwtPlotCanvas::PaintLayered or
+        QwtPlotCanvas::PaintAsynchronous the items are painted by
+        drawItem() and drawCanvas() is not called.
+  \sa drawItems(), QwtPlotCanvas::drawOverlay()
 */
 void QwtPlot::drawCanvas(QPainter *painter)
 {
@@ -476,8 +842,216 @@ void QwtPlot::drawCanvas(QPainter *painter)
     for ( int axisId = 0; axisId < axisCnt; axisId++ )
         maps[axisId] = canvasMap(axisId);
 
+    QwtPlotPrintFilter filter;
+    filter.setOptions(filter.options() & ~QwtPlotPrintFilter::PrintOverlay);
+
     drawItems(painter, 
-        d_data->canvas->contentsRect(), maps, QwtPlotPrintFilter());
+        d_data->canvas->contentsRect(), maps, filter);
+}
+
+/*
+  Items can be rendered into images and composited, without changing
+  the result, when the painter paints pixel aligned to a raster device
+ */
+static bool qwtCanComposite(const QPainter *painter, const QRect &rect)
+{
+    if ( !rect.isValid() )
+        return false;
+
+    const QPaintEngine *pe = painter->paintEngine();
+    if ( pe == nullptr || pe->type() != QPaintEngine::Raster )
+        return false;
+
+    const QTransform transform = painter->transform();
+    if ( transform.type() > QTransform::TxTranslate )
+        return false;
+
+    return transform.dx() == ::floor(transform.dx()) &&
+        transform.dy() == ::floor(transform.dy());
+}
+
+/*
+  Query a curve, reading only its spatial index or its data.
+  Without maps the region is in scale coordinates.
+ */
+template <typename Region>
+static inline QwtArray<int> qwtPointsInside(const QwtSpatialIndex *index,
+    const QwtData &data, const QwtScaleMap *xMap, const QwtScaleMap *yMap,
+    const Region &region)
+{
+    if ( xMap && yMap )
+    {
+        if ( index )
+            return index->pointsInside(*xMap, *yMap, region);
+
+        return QwtSpatialIndex::pointsInside(data, *xMap, *yMap, region);
+    }
+
+    if ( index )
+        return index->pointsInside(region);
+
+    return QwtSpatialIndex::pointsInside(data, region);
+}
+
+/*
+  Run a region query for all visible curves concurrently. When
+  xAxis/yAxis are >= 0, only curves attached to these axes are queried.
+  When inCanvas is true, the region is in canvas coordinates.
+
+  The canvas maps and the spatial indices are prepared in the
+  calling thread, so that the worker threads only read them.
+ */
+template <typename Region>
+static QMap<QwtPlotCurve *, QwtArray<int> > qwtCurvePointsInside(
+    const QwtPlot *plot, const Region &region,
+    int xAxis, int yAxis, bool inCanvas)
+{
+    QwtArray<QwtPlotCurve *> curves;
+
+    const QwtPlotItemList &items = plot->itemList();
+    for ( QwtPlotItemIterator it = items.begin(); it != items.end(); ++it )
+    {
+        QwtPlotItem *item = *it;
+        if ( item && item->isVisible() &&
+            item->rtti() == QwtPlotItem::Rtti_PlotCurve )
+        {
+            if ( xAxis >= 0 && item->xAxis() != xAxis )
+                continue;
+
+            if ( yAxis >= 0 && item->yAxis() != yAxis )
+                continue;
+
+            if ( ((QwtPlotCurve *)item)->dataSize() > 0 )
+                curves += (QwtPlotCurve *)item;
+        }
+    }
+
+    const int numCurves = curves.size();
+
+    QwtArray<const QwtSpatialIndex *> indexes(numCurves);
+    QwtArray<const QwtData *> data(numCurves);
+    QwtArray<QwtScaleMap> xMaps(numCurves);
+    QwtArray<QwtScaleMap> yMaps(numCurves);
+
+    for ( int i = 0; i < numCurves; i++ )
+    {
+        const QwtPlotCurve *curve = curves[i];
+
+        indexes[i] = curve->spatialIndex();
+        data[i] = &curve->data();
+
+        if ( inCanvas )
+        {
+            xMaps[i] = plot->canvasMap(curve->xAxis());
+            yMaps[i] = plot->canvasMap(curve->yAxis());
+        }
+    }
+
+    QwtArray< QwtArray<int> > indices(numCurves);
+
+    const QwtSpatialIndex **ix = indexes.data();
+    const QwtData **d = data.data();
+    const QwtScaleMap *xm = xMaps.data();
+    const QwtScaleMap *ym = yMaps.data();
+    QwtArray<int> *idx = indices.data();
+
+    QwtParallel::run(numCurves,
+        [&region, inCanvas, ix, d, xm, ym, idx](int i)
+    {
+        idx[i] = qwtPointsInside(ix[i], *d[i],
+            inCanvas ? xm + i : nullptr, inCanvas ? ym + i : nullptr,
+            region);
+    });
+
+    QMap<QwtPlotCurve *, QwtArray<int> > curvePoints;
+    for ( int i = 0; i < numCurves; i++ )
+    {
+        if ( !indices[i].isEmpty() )
+            curvePoints.insert(curves[i], indices[i]);
+    }
+
+    return curvePoints;
+}
+
+/*!
+  \brief Find the points of all visible curves inside of a rectangle
+
+  The curves are queried concurrently, using their spatial indices,
+  when enabled ( see QwtPlotCurve::setSpatialIndexEnabled() ).
+  Indices and canvas maps are prepared in the calling thread.
+
+  \param rect Rectangle in canvas coordinates, f.e. selected by a QwtPicker
+  \return Ascending indices of the points inside of rect for all
+          curves with at least one point inside
+*/
+QMap<QwtPlotCurve *, QwtArray<int> > QwtPlot::curvePointsInside(
+    const QRect &rect) const
+{
+    if ( rect.isEmpty() )
+        return QMap<QwtPlotCurve *, QwtArray<int> >();
+
+    // the pixels of the right/bottom border are included
+    const QwtDoubleRect canvasRect(rect.x(), rect.y(),
+        rect.width() - 1, rect.height() - 1);
+
+    return qwtCurvePointsInside(this, canvasRect, -1, -1, true);
+}
+
+/*!
+  \brief Find the points of all visible curves inside of a polygon
+
+  The curves are queried concurrently, using their spatial indices,
+  when enabled ( see QwtPlotCurve::setSpatialIndexEnabled() ).
+  Indices and canvas maps are prepared in the calling thread.
+
+  \param polygon Polygon in canvas coordinates, f.e. selected by a QwtPicker
+  \return Ascending indices of the points inside of polygon for all
+          curves with at least one point inside
+*/
+QMap<QwtPlotCurve *, QwtArray<int> > QwtPlot::curvePointsInside(
+    const QwtPolygon &polygon) const
+{
+    return qwtCurvePointsInside(this, QwtPolygonF(polygon), -1, -1, true);
+}
+
+/*!
+  \brief Find the points of the visible curves inside of a rectangle
+
+  Only the curves attached to xAxis and yAxis are queried, as the
+  rectangle is in the coordinates of these axes.
+
+  \param rect Rectangle in scale coordinates, f.e. selected by
+              a QwtPlotPicker
+  \param xAxis X axis of rect
+  \param yAxis Y axis of rect
+
+  \return Ascending indices of the points inside of rect for all
+          curves with at least one point inside
+*/
+QMap<QwtPlotCurve *, QwtArray<int> > QwtPlot::curvePointsInside(
+    const QwtDoubleRect &rect, int xAxis, int yAxis) const
+{
+    return qwtCurvePointsInside(this, rect, xAxis, yAxis, false);
+}
+
+/*!
+  \brief Find the points of the visible curves inside of a polygon
+
+  Only the curves attached to xAxis and yAxis are queried, as the
+  polygon is in the coordinates of these axes.
+
+  \param polygon Polygon in scale coordinates, f.e. selected by
+                 a QwtPlotPicker
+  \param xAxis X axis of polygon
+  \param yAxis Y axis of polygon
+
+  \return Ascending indices of the points inside of polygon for all
+          curves with at least one point inside
+*/
+QMap<QwtPlotCurve *, QwtArray<int> > QwtPlot::curvePointsInside(
+    const QwtPolygonF &polygon, int xAxis, int yAxis) const
+{
+    return qwtCurvePointsInside(this, polygon, xAxis, yAxis, false);
 }
 
 /*! 
@@ -492,6 +1066,8 @@ void QwtPlot::drawItems(QPainter *painter, const QRect &rect,
         const QwtScaleMap map[axisCnt], 
         const QwtPlotPrintFilter &pfilter) const
 {
+    QwtArray<const QwtPlotItem *> items;
+
     const QwtPlotItemList& itmList = itemList();
     for ( QwtPlotItemIterator it = itmList.begin();
         it != itmList.end(); ++it )
@@ -505,16 +1081,130 @@ void QwtPlot::drawItems(QPainter *painter, const QRect &rect,
                 continue;
             }
 
-            painter->save();
-
-            painter->setRenderHint(QPainter::Antialiasing, item->testRenderHint(QwtPlotItem::RenderAntialiased) );
-            item->draw(painter, 
-                map[item->xAxis()], map[item->yAxis()],
-                rect);
+            if ( !(pfilter.options() & QwtPlotPrintFilter::PrintOverlay)
+                && item->testItemAttribute(QwtPlotItem::Overlay) )
+            {
+                continue;
+            }
 
-            painter->restore();
+            items += item;
         }
     }
+
+    const int numItems = items.size();
+
+    if ( !d_data->parallelRendering || numItems < 2
+        || QwtParallel::threadCount() < 2
+        || !qwtCanComposite(painter, rect) )
+    {
+        for ( int i = 0; i < numItems; i++ )
+            drawItem(painter, items[i], rect, map);
+
+        return;
+    }
+
+    // the initial state of the painter, that is passed to the items
+
+    const QPainter::RenderHints hints = painter->renderHints();
+    const QPen pen = painter->pen();
+    const QBrush brush = painter->brush();
+    const QFont font = painter->font();
+
+    qreal ratio = 1.0;
+#if QT_VERSION >= 0x050600
+    if ( painter->device() )
+        ratio = painter->device()->devicePixelRatioF();
+#endif
+
+    const QSize imageSize(int(::ceil(rect.width() * ratio)),
+        int(::ceil(rect.height() * ratio)));
+
+    QwtArray<QImage> images(numItems);
+    QImage *imageData = images.data();
+
+    const QwtPlotItem *const *itemData = items.constData();
+
+    const QwtPainterContext *painterContext = QwtPainter::context();
+
+    QwtParallel::run(numItems, [&](int i)
+    {
+        // the items might modify the context, f.e. QwtPlotScaleItem
+        QwtPainterContext context(*painterContext);
+        QwtPainterContext *previousContext = QwtPainter::setContext(&context);
+
+        QImage image(imageSize, QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(ratio);
+        image.fill(0);
+
+        QPainter itemPainter(&image);
+        itemPainter.setRenderHints(hints);
+        itemPainter.setPen(pen);
+        itemPainter.setBrush(brush);
+        itemPainter.setFont(font);
+        itemPainter.translate(-rect.x(), -rect.y());
+
+        drawItem(&itemPainter, itemData[i], rect, map);
+        itemPainter.end();
+
+        QwtPainter::setContext(previousContext);
+
+        imageData[i] = image;
+    });
+
+    // the items are sorted by z
+    for ( int i = 0; i < numItems; i++ )
+        painter->drawImage(rect.topLeft(), images[i]);
+}
+
+/*!
+  Draw a single item
+
+  The state of the painter is saved and restored and the
+  render hints of the item are applied.
+
+  \param painter Painter used for drawing
+  \param item Plot item
+  \param rect Bounding rectangle where to paint
+  \param maps QwtPlot::axisCnt maps, mapping between plot and paint
+              device coordinates
+
+  \sa drawItems(), QwtPlotCanvas::PaintLayered
+*/
+void QwtPlot::drawItem(QPainter *painter, const QwtPlotItem *item,
+    const QRect &rect, const QwtScaleMap maps[axisCnt]) const
+{
+    // drawItem might be called from different threads
+    const bool record = d_data->isRecordingItems;
+
+    QwtReplotStatistics::ItemStatistics statistics(
+        record ? item : nullptr);
+    QwtReplotStatistics::ItemStatistics *previousStatistics = nullptr;
+
+    QElapsedTimer timer;
+    if ( record )
+    {
+        previousStatistics =
+            QwtReplotStatistics::setCurrentItem(&statistics);
+        timer.start();
+    }
+
+    painter->save();
+
+    painter->setRenderHint(QPainter::Antialiasing, item->testRenderHint(QwtPlotItem::RenderAntialiased) );
+    item->draw(painter,
+        maps[item->xAxis()], maps[item->yAxis()],
+        rect);
+
+    painter->restore();
+
+    if ( record )
+    {
+        statistics.drawTime = timer.nsecsElapsed();
+        QwtReplotStatistics::setCurrentItem(previousStatistics);
+
+        QMutexLocker locker(&d_data->statisticsMutex);
+        d_data->statistics.addItem(statistics);
+    }
 }
 
 /*!
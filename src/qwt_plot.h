@@ -11,12 +11,17 @@
 #define QWT_PLOT_H
 
 #include <qframe.h>
+#include <qmap.h>
+#include <qregion.h>
 #include "qwt_global.h"
 #include "qwt_array.h"
 #include "qwt_text.h"
+#include "qwt_replot_statistics.h"
 #include "qwt_plot_dict.h"
 #include "qwt_scale_map.h"
 #include "qwt_plot_printfilter.h"
+#include "qwt_polygon.h"
+#include "qwt_double_rect.h"
 
 class QwtPlotLayout;
 class QwtLegend;
@@ -27,6 +32,7 @@ class QwtScaleDraw;
 class QwtTextLabel;
 class QwtPlotCanvas;
 class QwtPlotPrintFilter;
+class QwtPlotCurve;
 
 /*!
   \brief A 2-D plotting widget
@@ -137,6 +143,25 @@ public:
     void setAutoReplot(bool tf = true);
     bool autoReplot() const;
 
+    void setDeferredReplot(bool on = true);
+    bool deferredReplot() const;
+
+    void setMaxReplotRate(double framesPerSecond);
+    double maxReplotRate() const;
+
+    bool isReplotPending() const;
+
+    void addDamagedRect(const QRect &);
+    QRegion damagedRegion() const;
+
+    void setParallelRendering(bool on = true);
+    bool parallelRendering() const;
+
+    void setStatisticsEnabled(bool on = true);
+    bool statisticsEnabled() const;
+
+    QwtReplotStatistics replotStatistics() const;
+
     void print(QPaintDevice &p,
         const QwtPlotPrintFilter & = QwtPlotPrintFilter()) const;
     virtual void print(QPainter *, const QRect &rect,
@@ -225,6 +250,18 @@ public:
     QwtLegend *legend();
     const QwtLegend *legend() const;
 
+    // Region queries
+
+    QMap<QwtPlotCurve *, QwtArray<int> > curvePointsInside(
+        const QRect &) const;
+    QMap<QwtPlotCurve *, QwtArray<int> > curvePointsInside(
+        const QwtPolygon &) const;
+
+    QMap<QwtPlotCurve *, QwtArray<int> > curvePointsInside(
+        const QwtDoubleRect &, int xAxis = xBottom, int yAxis = yLeft) const;
+    QMap<QwtPlotCurve *, QwtArray<int> > curvePointsInside(
+        const QwtPolygonF &, int xAxis = xBottom, int yAxis = yLeft) const;
+
     // Misc
 
     virtual void polish();
@@ -234,6 +271,9 @@ public:
     virtual void updateLayout();
     virtual void drawCanvas(QPainter *);
 
+    void drawItem(QPainter *, const QwtPlotItem *, const QRect &,
+        const QwtScaleMap maps[axisCnt]) const;
+
     void updateAxes();
 
     virtual bool event(QEvent *);
@@ -265,11 +305,21 @@ signals:
 
     void legendChecked(QwtPlotItem *plotItem, bool on);
 
+    /*!
+      A signal, that is emitted after each replot, when statistics
+      are enabled
+
+      \param statistics Timings and counters of the replot
+      \sa setStatisticsEnabled(), replotStatistics()
+     */
+    void statisticsUpdated(const QwtReplotStatistics &statistics);
+
 public slots:
     virtual void clear();
 
     virtual void replot();
     void autoRefresh();
+    void flushReplot();
 
 protected slots:
     virtual void legendItemClicked();
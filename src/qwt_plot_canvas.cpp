@@ -9,7 +9,12 @@
 
 // vim: expandtab
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <qpainter.h>
+#include <qimage.h>
+#include <qmap.h>
 #include <qstyle.h>
 #include <qstyleoption.h>
 #include <qpaintengine.h>
@@ -17,11 +22,125 @@
 #include <qx11info_x11.h>
 #endif
 #include <qevent.h>
+#include <qrunnable.h>
+#include <qthreadpool.h>
 #include "qwt_painter.h"
+#include "qwt_painter_context.h"
 #include "qwt_math.h"
 #include "qwt_plot.h"
+#include "qwt_scale_map.h"
 #include "qwt_plot_canvas.h"
 
+static inline bool qwtSameMap(const QwtScaleMap &map1,
+    const QwtScaleMap &map2)
+{
+    return map1.s1() == map2.s1() && map1.s2() == map2.s2() &&
+        map1.p1() == map2.p1() && map1.p2() == map2.p2() &&
+        map1.transformation()->type() == map2.transformation()->type();
+}
+
+static inline bool qwtIsCached(const QwtPlotItem *item)
+{
+    return item->isVisible() &&
+        !item->testItemAttribute(QwtPlotItem::Overlay);
+}
+
+/*
+  Scale factor and offset, that translate the paint coordinates of
+  the map "from" into those of the map "to". Only linear maps
+  can be translated.
+ */
+static bool qwtRescaleMap(const QwtScaleMap &from, const QwtScaleMap &to,
+    double &scale, double &offset)
+{
+    if ( from.transformation()->type() != QwtScaleTransformation::Linear ||
+        to.transformation()->type() != QwtScaleTransformation::Linear )
+    {
+        return false;
+    }
+
+    const double ds1 = from.s2() - from.s1();
+    const double ds2 = to.s2() - to.s1();
+    const double dp1 = from.p2() - from.p1();
+
+    if ( ds1 == 0.0 || ds2 == 0.0 || dp1 == 0.0 )
+        return false;
+
+    const double k1 = dp1 / ds1;
+    const double k2 = (to.p2() - to.p1()) / ds2;
+
+    scale = k2 / k1;
+    offset = to.p1() + (from.s1() - to.s1()) * k2 - from.p1() * scale;
+
+    return true;
+}
+
+class QwtPlotCanvasTask: public QRunnable
+{
+public:
+    QwtPlotCanvasTask(const std::function<void()> &function):
+        _function(function)
+    {
+        setAutoDelete(true);
+    }
+
+    virtual void run()
+    {
+        _function();
+    }
+
+private:
+    const std::function<void()> _function;
+};
+
+/*
+  PaintAsynchronous: snapshot of the plot, that is rendered
+  in a worker thread
+ */
+class QwtPlotCanvas::RenderJob
+{
+public:
+    RenderJob():
+        plot(nullptr),
+        cancelled(false)
+    {
+    }
+
+    void render()
+    {
+        QwtPainterContext *previousContext =
+            QwtPainter::setContext(&painterContext);
+
+        image = QImage(rect.size(), QImage::Format_ARGB32_Premultiplied);
+
+        QPainter painter(&image);
+        painter.fillRect(image.rect(), background);
+        painter.translate(-rect.x(), -rect.y());
+
+        for ( QwtPlotItemIterator it = items.begin();
+            it != items.end(); ++it )
+        {
+            if ( cancelled )
+                break;
+
+            if ( qwtIsCached(*it) )
+                plot->drawItem(&painter, *it, rect, maps);
+        }
+
+        QwtPainter::setContext(previousContext);
+    }
+
+    const QwtPlot *plot;
+    QwtPlotItemList items;
+    QRect rect;
+    QBrush background;
+    QwtScaleMap maps[QwtPlot::axisCnt];
+    QwtPainterContext painterContext;
+
+    QImage image;
+    std::atomic<bool> cancelled;
+};
+
 class QwtPlotCanvas::PrivateData
 {
 public:
@@ -30,6 +149,8 @@ public:
         paintAttributes(0),
         cache(nullptr)
     {
+        // renders are serialized, a newer one cancels the older ones
+        renderPool.setMaxThreadCount(1);
     }
 
     ~PrivateData()
@@ -40,8 +161,50 @@ public:
     FocusIndicator focusIndicator;
     int paintAttributes;
     QPixmap *cache;
+
+    bool syncMaps(const QwtPlot *, const QSize &);
+
+    bool isAsynchronous() const
+    {
+        return (paintAttributes & QwtPlotCanvas::PaintAsynchronous)
+            && cache != nullptr;
+    }
+
+    // PaintLayered: one image for each z value
+    QMap<double, QImage> layers;
+
+    // geometry of the cached contents
+    QSize cacheSize;
+    QwtScaleMap cacheMaps[QwtPlot::axisCnt];
+
+    // PaintAsynchronous: the latest render, that has been started
+    QThreadPool renderPool;
+    std::shared_ptr<QwtPlotCanvas::RenderJob> renderJob;
 };
 
+/*
+  Remember the geometry of the cached contents and return
+  true, when it differs from the previous one
+ */
+bool QwtPlotCanvas::PrivateData::syncMaps(
+    const QwtPlot *plot, const QSize &size)
+{
+    bool changed = size != cacheSize;
+    cacheSize = size;
+
+    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+    {
+        const QwtScaleMap map = plot->canvasMap(axisId);
+        if ( !qwtSameMap(map, cacheMaps[axisId]) )
+        {
+            cacheMaps[axisId] = map;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
 //! Sets a cross cursor, enables QwtPlotCanvas::PaintCached
 
 QwtPlotCanvas::QwtPlotCanvas(QwtPlot *plot):
@@ -62,6 +225,7 @@ QwtPlotCanvas::QwtPlotCanvas(QwtPlot *plot):
 //! Destructor
 QwtPlotCanvas::~QwtPlotCanvas()
 {
+    cancelRender();
     delete d_data;
 }
 
@@ -127,6 +291,8 @@ void QwtPlotCanvas::setPaintAttribute(PaintAttribute attribute, bool on)
             }
             else
             {
+                cancelRender();
+
                 delete d_data->cache;
                 d_data->cache = nullptr;
             }
@@ -146,6 +312,22 @@ void QwtPlotCanvas::setPaintAttribute(PaintAttribute attribute, bool on)
 
             break;
         }
+        case PaintLayered:
+        {
+            if ( !on )
+                d_data->layers.clear();
+
+            break;
+        }
+        case PaintAsynchronous:
+        {
+            if ( !on )
+                cancelRender();
+
+            break;
+        }
+        default:
+            break;
     }
 }
 
@@ -173,11 +355,43 @@ const QPixmap *QwtPlotCanvas::paintCache() const
     return d_data->cache;
 }
 
-//! Invalidate the internal paint cache
+//! Invalidate the internal paint cache including all layers
 void QwtPlotCanvas::invalidatePaintCache()
 {
     if ( d_data->cache )
         *d_data->cache = QPixmap();
+
+    d_data->layers.clear();
+}
+
+/*!
+  \brief Cached image of a layer
+
+  \param z Z value of the items of the layer
+  \return Image of the layer, or nullptr, when the layer is not cached
+  \sa PaintLayered, invalidateLayer()
+*/
+QImage *QwtPlotCanvas::layerCache(double z)
+{
+    QMap<double, QImage>::iterator it = d_data->layers.find(z);
+    if ( it == d_data->layers.end() )
+        return nullptr;
+
+    return &it.value();
+}
+
+/*!
+  \brief Invalidate the cached image of a layer
+
+  The layer is rendered again with the next replot.
+  QwtPlotItem::itemChanged() invalidates the layer of the item.
+
+  \param z Z value of the items of the layer
+  \sa PaintLayered, layerCache(), invalidatePaintCache()
+*/
+void QwtPlotCanvas::invalidateLayer(double z)
+{
+    d_data->layers.remove(z);
 }
 
 /*!
@@ -247,7 +461,18 @@ void QwtPlotCanvas::paintEvent(QPaintEvent *event)
 */
 void QwtPlotCanvas::drawContents(QPainter *painter)
 {
-    if ( d_data->paintAttributes & PaintCached && d_data->cache 
+    if ( d_data->isAsynchronous() )
+    {
+        // a resized canvas needs a new frame
+        if ( !isRendering()
+            && d_data->cache->size() != contentsRect().size() )
+        {
+            startRender();
+        }
+
+        drawPreviousFrame(painter);
+    }
+    else if ( d_data->paintAttributes & PaintCached && d_data->cache
         && d_data->cache->size() == contentsRect().size() )
     {
         painter->drawPixmap(contentsRect().topLeft(), *d_data->cache);
@@ -263,6 +488,8 @@ void QwtPlotCanvas::drawContents(QPainter *painter)
         plot->setAutoReplot(doAutoReplot);
     }
 
+    drawOverlay(painter);
+
     if ( hasFocus() && focusIndicator() == CanvasFocusIndicator )
         drawFocusIndicator(painter);
 }
@@ -313,10 +540,21 @@ void QwtPlotCanvas::drawCanvas(QPainter *painter)
 #endif
 
         QPainter cachePainter(d_data->cache);
-        cachePainter.translate(-contentsRect().x(),
-            -contentsRect().y());
 
-        ((QwtPlot *)parent())->drawCanvas(&cachePainter);
+        if ( d_data->paintAttributes & PaintLayered )
+        {
+            drawLayers(&cachePainter);
+        }
+        else
+        {
+            d_data->syncMaps((const QwtPlot *)parent(),
+                contentsRect().size());
+
+            cachePainter.translate(-contentsRect().x(),
+                -contentsRect().y());
+
+            ((QwtPlot *)parent())->drawCanvas(&cachePainter);
+        }
 
         cachePainter.end();
 
@@ -339,6 +577,107 @@ void QwtPlotCanvas::drawCanvas(QPainter *painter)
     }
 }
 
+/*
+  Render the layers, that are not cached, and composite all layers
+  in z order. painter paints to the paint cache.
+ */
+void QwtPlotCanvas::drawLayers(QPainter *painter)
+{
+    const QwtPlot *plot = (const QwtPlot *)parent();
+    const QRect cr = contentsRect();
+
+    if ( d_data->syncMaps(plot, cr.size()) )
+        d_data->layers.clear();
+
+    const QwtScaleMap *maps = d_data->cacheMaps;
+
+    // the items are sorted by z
+
+    QMap<double, QImage> layers;
+
+    const QwtPlotItemList &items = plot->itemList();
+
+    QwtPlotItemIterator it = items.begin();
+    while ( it != items.end() )
+    {
+        const double z = (*it)->z();
+
+        bool isVisible = false;
+
+        QwtPlotItemIterator end = it;
+        for ( ; end != items.end() && (*end)->z() == z; ++end )
+        {
+            if ( qwtIsCached(*end) )
+                isVisible = true;
+        }
+
+        if ( isVisible )
+        {
+            QImage image = d_data->layers.value(z);
+            if ( image.isNull() )
+            {
+                image = QImage(cr.size(), QImage::Format_ARGB32_Premultiplied);
+                image.fill(0);
+
+                QPainter layerPainter(&image);
+                layerPainter.translate(-cr.x(), -cr.y());
+
+                for ( QwtPlotItemIterator i = it; i != end; ++i )
+                {
+                    if ( qwtIsCached(*i) )
+                        plot->drawItem(&layerPainter, *i, cr, maps);
+                }
+            }
+
+            painter->drawImage(0, 0, image);
+            layers.insert(z, image);
+        }
+
+        it = end;
+    }
+
+    d_data->layers = layers;
+}
+
+/*!
+  Draw the items with the QwtPlotItem::Overlay attribute
+
+  The overlay is painted on top of the cached contents for
+  each paint event.
+
+  \param painter Painter
+  \sa updateOverlay(), QwtPlotItem::Overlay
+*/
+void QwtPlotCanvas::drawOverlay(QPainter *painter)
+{
+    const QwtPlot *plot = this->plot();
+    if ( plot == nullptr )
+        return;
+
+    const QwtPlotItemList &items = plot->itemList();
+
+    QwtScaleMap maps[QwtPlot::axisCnt];
+    bool hasMaps = false;
+
+    for ( QwtPlotItemIterator it = items.begin(); it != items.end(); ++it )
+    {
+        const QwtPlotItem *item = *it;
+        if ( item->isVisible() &&
+            item->testItemAttribute(QwtPlotItem::Overlay) )
+        {
+            if ( !hasMaps )
+            {
+                for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+                    maps[axisId] = plot->canvasMap(axisId);
+
+                hasMaps = true;
+            }
+
+            plot->drawItem(painter, item, contentsRect(), maps);
+        }
+    }
+}
+
 /*! 
   Draw the focus indication
   \param painter Painter
@@ -361,11 +700,30 @@ void QwtPlotCanvas::setSystemBackground(bool on)
 
 /*!
    Invalidate the paint cache and repaint the canvas
-   \sa invalidatePaintCache()
+
+   With PaintLayered only the layers, that have been invalidated,
+   are rendered again.
+
+   \sa invalidatePaintCache(), invalidateLayer()
 */
 void QwtPlotCanvas::replot()
 {
-    invalidatePaintCache();
+    if ( d_data->isAsynchronous() )
+    {
+        startRender();
+        return;
+    }
+
+    if ( d_data->paintAttributes & PaintLayered )
+    {
+        // the layers are recomposited, but only rendered when invalid
+        if ( d_data->cache )
+            *d_data->cache = QPixmap();
+    }
+    else
+    {
+        invalidatePaintCache();
+    }
 
     /*
       In case of cached or packed painting the canvas
@@ -384,3 +742,231 @@ void QwtPlotCanvas::replot()
     if ( !erase && !noBackgroundMode )
         setAttribute(Qt::WA_OpaquePaintEvent, false);
 }
+
+/*!
+   Repaint the damaged areas of the canvas
+
+   Only the areas of the paint cache, that intersect with damage,
+   are painted again. With PaintLayered the layers, that have been
+   invalidated, are rendered completely, but only the damaged areas
+   are composited. When the canvas is not cached, or the size of the
+   canvas or the scales have been changed, the complete canvas is
+   replotted.
+
+   \param damage Damaged areas in canvas coordinates
+   \sa PaintDamaged, QwtPlot::addDamagedRect()
+*/
+void QwtPlotCanvas::replot(const QRegion &damage)
+{
+    const QRect cr = contentsRect();
+    const QwtPlot *plot = this->plot();
+
+    if ( plot == nullptr || d_data->isAsynchronous()
+        || !(d_data->paintAttributes & PaintCached)
+        || d_data->cache == nullptr || d_data->cache->isNull()
+        || d_data->cache->size() != cr.size() )
+    {
+        replot();
+        return;
+    }
+
+    if ( d_data->syncMaps(plot, cr.size()) )
+    {
+        d_data->layers.clear();
+        replot();
+        return;
+    }
+
+    const QRegion region = damage & cr;
+    if ( region.isEmpty() )
+        return;
+
+    QPainter cachePainter(d_data->cache);
+    cachePainter.setClipRegion(region.translated(-cr.topLeft()));
+
+    cachePainter.fillRect(d_data->cache->rect(),
+        palette().brush(backgroundRole()));
+
+    if ( d_data->paintAttributes & PaintLayered )
+    {
+        drawLayers(&cachePainter);
+    }
+    else
+    {
+        cachePainter.translate(-cr.x(), -cr.y());
+        ((QwtPlot *)parent())->drawCanvas(&cachePainter);
+    }
+
+    cachePainter.end();
+
+    const bool noBackgroundMode = testAttribute(Qt::WA_OpaquePaintEvent);
+    if ( !noBackgroundMode )
+        setAttribute(Qt::WA_OpaquePaintEvent, true);
+
+    repaint(region);
+
+    if ( !noBackgroundMode )
+        setAttribute(Qt::WA_OpaquePaintEvent, false);
+}
+
+/*!
+   Repaint the canvas from its paint cache
+
+   The cached contents are not rendered again, only the items with
+   the QwtPlotItem::Overlay attribute are painted.
+
+   \sa drawOverlay(), replot()
+*/
+void QwtPlotCanvas::updateOverlay()
+{
+    update(contentsRect());
+}
+
+/*!
+   \return true, when an asynchronous render is running or queued
+   \sa PaintAsynchronous, waitForRender(), cancelRender()
+*/
+bool QwtPlotCanvas::isRendering() const
+{
+    return d_data->renderJob != nullptr;
+}
+
+/*!
+   \brief Block until the running asynchronous render has been completed
+
+   The new frame is copied into the paint cache and renderFinished()
+   is emitted before waitForRender() returns.
+
+   \sa PaintAsynchronous, cancelRender()
+*/
+void QwtPlotCanvas::waitForRender()
+{
+    if ( d_data->renderJob )
+    {
+        d_data->renderPool.waitForDone();
+        finishRender(d_data->renderJob.get());
+    }
+}
+
+/*!
+   \brief Cancel the running asynchronous render
+
+   Items are checked for cancellation between them, so
+   cancelRender() blocks until the item, that is painted
+   in the worker thread, has been completed. The canvas keeps
+   showing the previous frame.
+
+   \sa PaintAsynchronous, waitForRender()
+*/
+void QwtPlotCanvas::cancelRender()
+{
+    if ( d_data->renderJob )
+    {
+        d_data->renderJob->cancelled = true;
+        d_data->renderJob.reset();
+    }
+
+    // cancelled renders might still be running
+    d_data->renderPool.waitForDone();
+}
+
+/*
+  Take a snapshot of the items and the scale maps and render it
+  in a worker thread. A render, that is still running, is cancelled.
+ */
+void QwtPlotCanvas::startRender()
+{
+    const QwtPlot *plot = this->plot();
+    if ( plot == nullptr || !contentsRect().isValid() )
+        return;
+
+    if ( d_data->renderJob )
+        d_data->renderJob->cancelled = true;
+
+    std::shared_ptr<RenderJob> job(new RenderJob());
+    job->plot = plot;
+    job->items = plot->itemList();
+    job->rect = contentsRect();
+    job->background = palette().brush(backgroundRole());
+    job->painterContext = *QwtPainter::context();
+
+    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+        job->maps[axisId] = plot->canvasMap(axisId);
+
+    d_data->renderJob = job;
+
+    d_data->renderPool.start(new QwtPlotCanvasTask([this, job]()
+    {
+        if ( !job->cancelled )
+            job->render();
+
+        QMetaObject::invokeMethod(this,
+            [this, job]() { finishRender(job.get()); },
+            Qt::QueuedConnection);
+    }));
+}
+
+/*
+  Take the image of a completed render into the paint cache,
+  unless a newer render has been started in the meantime.
+ */
+void QwtPlotCanvas::finishRender(RenderJob *job)
+{
+    if ( job != d_data->renderJob.get() )
+        return;
+
+    const std::shared_ptr<RenderJob> finished = d_data->renderJob;
+    d_data->renderJob.reset();
+
+    if ( d_data->cache == nullptr )
+        return;
+
+    *d_data->cache = QPixmap::fromImage(finished->image);
+
+    d_data->cacheSize = finished->rect.size();
+    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+        d_data->cacheMaps[axisId] = finished->maps[axisId];
+
+    update(contentsRect());
+
+    emit renderFinished();
+}
+
+/*
+  PaintAsynchronous: paint the frame of the last completed render,
+  rescaled to the current maps with PaintRescaled.
+ */
+void QwtPlotCanvas::drawPreviousFrame(QPainter *painter)
+{
+    const QRect cr = contentsRect();
+    const QPixmap &frame = *d_data->cache;
+
+    QTransform transform;
+
+    const QwtPlot *plot = this->plot();
+    if ( plot && (d_data->paintAttributes & PaintRescaled) )
+    {
+        double sx, dx, sy, dy;
+        if ( qwtRescaleMap(d_data->cacheMaps[QwtPlot::xBottom],
+                plot->canvasMap(QwtPlot::xBottom), sx, dx) &&
+            qwtRescaleMap(d_data->cacheMaps[QwtPlot::yLeft],
+                plot->canvasMap(QwtPlot::yLeft), sy, dy) )
+        {
+            transform = QTransform(sx, 0.0, 0.0, sy, dx, dy);
+        }
+    }
+
+    if ( frame.isNull() || frame.size() != cr.size()
+        || !transform.isIdentity() )
+    {
+        painter->fillRect(cr, palette().brush(backgroundRole()));
+    }
+
+    if ( !frame.isNull() )
+    {
+        painter->save();
+        painter->setTransform(transform, true);
+        painter->drawPixmap(cr.topLeft(), frame);
+        painter->restore();
+    }
+}
@@ -18,6 +18,7 @@
 
 class QwtPlot;
 class QPixmap;
+class QImage;
 
 /*!
   \brief Canvas of a QwtPlot. 
@@ -36,8 +37,10 @@ public:
         Paint double buffered and reuse the content of the pixmap buffer 
         for some spontaneous repaints that happen when a plot gets unhidden, 
         deiconified or changes the focus.
-        Disabling the cache will improve the performance for
-        incremental paints (using QwtPlotCurve::draw). 
+        Incremental paints ( using QwtPlotCurve::draw(from, to) )
+        are painted into the cache and need to repaint only the
+        area of the new points. Without the cache the complete
+        canvas has to be repainted.
 
       - PaintPacked\n
         Suppress system background repaints and paint it together with 
@@ -46,6 +49,57 @@ public:
         when there is a notable gap between painting the background
         and the plot contents.
 
+      - PaintLayered\n
+        ( in combination with PaintCached only )\n
+        The items are grouped into layers of items with the same z value.
+        Each layer is rendered into an image of its own, that is
+        cached until an item of the layer reports a change by
+        QwtPlotItem::itemChanged(), or the scales or the size of
+        the canvas have been changed. A replot renders only the
+        invalidated layers and composites all layers in z order.
+        Items are painted by QwtPlot::drawItem(), so reimplementations
+        of QwtPlot::drawItems() are not called in this mode. When the
+        data of an item has been modified without notification,
+        invalidateLayer() has to be called.
+
+      - PaintDamaged\n
+        ( in combination with PaintCached only )\n
+        QwtPlot::replot() repaints only the areas of the canvas,
+        that have been reported by QwtPlotItem::itemChanged()
+        ( see QwtPlot::addDamagedRect() ), as long as the scales
+        and the size of the canvas are unchanged. Items, that are
+        modified without notification, need a call of
+        invalidatePaintCache() before the replot.
+
+      - PaintAsynchronous\n
+        ( in combination with PaintCached only )\n
+        replot() renders the items into an image in a worker thread
+        and returns immediately. Until the image is ready the canvas
+        keeps showing the previous frame from the paint cache.
+        A render, that is still running, when the next replot is
+        requested, is cancelled. When a render has been completed,
+        renderFinished() is emitted.
+        The items are painted from the worker thread. All methods
+        of the plot items, that modify them, wait for a running
+        render before ( see QwtPlotItem::waitForRender() ).
+        Derived items have to do the same in their own setters.
+        Objects, that are shared with an item and modified
+        without it, like the memory of QwtPlotCurve::setRawData(),
+        need a call of waitForRender() or cancelRender() before.
+        Items are painted by QwtPlot::drawItem(),
+        so reimplementations of QwtPlot::drawCanvas() and
+        QwtPlot::drawItems() are not called in this mode. Derived
+        items also have to call QwtPlotItem::detach() in their destructor
+        ( see QwtPlotItem::~QwtPlotItem() ). PaintLayered and
+        PaintDamaged are ignored in this mode.
+
+      - PaintRescaled\n
+        ( in combination with PaintAsynchronous only )\n
+        While a render is running the previous frame is scaled and
+        translated according to the current maps of the xBottom and
+        yLeft axes, so that it roughly matches the new scales.
+        This is done for linear scales only.
+
       The default setting enables PaintCached and PaintPacked
 
       \sa setPaintAttribute(), testPaintAttribute(), paintCache()
@@ -53,7 +107,11 @@ public:
     enum PaintAttribute
     {
         PaintCached = 1,
-        PaintPacked = 2
+        PaintPacked = 2,
+        PaintLayered = 4,
+        PaintDamaged = 8,
+        PaintAsynchronous = 16,
+        PaintRescaled = 32
     };
 
     /*!
@@ -97,7 +155,25 @@ public:
     const QPixmap *paintCache() const;
     void invalidatePaintCache();
 
+    QImage *layerCache(double z);
+    void invalidateLayer(double z);
+
     void replot();
+    void replot(const QRegion &);
+    void updateOverlay();
+
+    bool isRendering() const;
+    void waitForRender();
+    void cancelRender();
+
+signals:
+    /*!
+      A signal, that is emitted, when an asynchronous render has
+      been completed and the new frame is in the paint cache.
+
+      \sa PaintAsynchronous, isRendering()
+     */
+    void renderFinished();
 
 protected:
     virtual void hideEvent(QHideEvent *);
@@ -106,11 +182,19 @@ protected:
 
     virtual void drawContents(QPainter *);
     virtual void drawFocusIndicator(QPainter *);
+    virtual void drawOverlay(QPainter *);
 
     void drawCanvas(QPainter *painter = nullptr);
 
 private:    
     void setSystemBackground(bool);
+    void drawLayers(QPainter *);
+
+    class RenderJob;
+
+    void startRender();
+    void finishRender(RenderJob *);
+    void drawPreviousFrame(QPainter *);
 
     class PrivateData;
     PrivateData *d_data;
@@ -7,162 +7,589 @@
  * modify it under the terms of the Qwt License, Version 1.0
  *****************************************************************************/
 
+#include <atomic>
 #include <qpainter.h>
 #include <qpixmap.h>
-#include <qbitarray.h>
+#include <qimage.h>
+#include <qvector.h>
 #include "qwt_global.h"
 #include "qwt_legend.h"
 #include "qwt_legend_item.h"
 #include "qwt_data.h"
+#include "qwt_data_pyramid.h"
+#include "qwt_spatial_index.h"
 #include "qwt_scale_map.h"
 #include "qwt_double_rect.h"
 #include "qwt_math.h"
+#include "qwt_parallel.h"
 #include "qwt_clipper.h"
+#include "qwt_column_reducer.h"
+#include "qwt_color_map.h"
 #include "qwt_painter.h"
 #include "qwt_plot.h"
 #include "qwt_plot_canvas.h"
+#include "qwt_scale_engine.h"
+#include "qwt_scale_div.h"
+#include "qwt_replot_statistics.h"
 #include "qwt_curve_fitter.h"
 #include "qwt_symbol.h"
 #include "qwt_plot_curve.h"
 
-#include <qpointer.h>
-#include <qevent.h>
-#include <qpaintengine.h>
+static inline bool qwtSameMap(const QwtScaleMap &map1, 
+    const QwtScaleMap &map2)
+{
+    return map1.s1() == map2.s1() && map1.s2() == map2.s2() &&
+        map1.p1() == map2.p1() && map1.p2() == map2.p2() &&
+        map1.transformation()->type() == map2.transformation()->type();
+}
 
-class QwtPlotCurvePaintHelper: public QObject
+static inline bool qwtIsLinear(const QwtScaleMap &map)
 {
-public:
-    QwtPlotCurvePaintHelper(const QwtPlotCurve *curve, int from, int to):
-        _curve(curve),
-        _from(from),
-        _to(to)
+    return map.transformation()->type() == QwtScaleTransformation::Linear;
+}
+
+/*
+  Check, if a replot would change the scale of an axis, because
+  autoscaling results in a different scale division for the
+  bounding rectangles of the items. See QwtPlot::updateAxes().
+ */
+static bool qwtAutoScaleChanged(const QwtPlot *plot, int axisId)
+{
+    if ( !plot->axisAutoScale(axisId) )
+        return false;
+
+    QwtDoubleInterval intv;
+
+    const QwtPlotItemList& itmList = plot->itemList();
+    for ( QwtPlotItemIterator it = itmList.begin();
+        it != itmList.end(); ++it )
     {
+        const QwtPlotItem *item = *it;
+        if ( !item->testItemAttribute(QwtPlotItem::AutoScale) )
+            continue;
+
+        if ( item->xAxis() == axisId )
+        {
+            const QwtDoubleRect rect = item->boundingRect();
+            intv |= QwtDoubleInterval(rect.left(), rect.right());
+        }
+        else if ( item->yAxis() == axisId )
+        {
+            const QwtDoubleRect rect = item->boundingRect();
+            intv |= QwtDoubleInterval(rect.top(), rect.bottom());
+        }
     }
 
-    virtual bool eventFilter(QObject *, QEvent *event)
+    if ( !intv.isValid() )
+        return false;
+
+    const QwtScaleEngine *engine = plot->axisScaleEngine(axisId);
+
+    double minValue = intv.minValue();
+    double maxValue = intv.maxValue();
+    double stepSize = plot->axisStepSize(axisId);
+
+    engine->autoScale(plot->axisMaxMajor(axisId),
+        minValue, maxValue, stepSize);
+
+    const QwtScaleDiv scaleDiv = engine->divideScale(minValue, maxValue,
+        plot->axisMaxMajor(axisId), plot->axisMaxMinor(axisId), stepSize);
+
+    return scaleDiv != *plot->axisScaleDiv(axisId);
+}
+
+static int verifyRange(int size, int &i1, int &i2)
+{
+    if (size < 1)
+        return 0;
+
+    i1 = qwtLim(i1, 0, size-1);
+    i2 = qwtLim(i2, 0, size-1);
+
+    if ( i1 > i2 )
+        qSwap(i1, i2);
+
+    return (i2 - i1 + 1);
+}
+
+/*
+  Binary search in points, that are ordered in x ( or y ) direction.
+  Returns the index of the first point in [from, to], that is not in
+  front of value ( behind value for upper ), or to + 1.
+ */
+static int qwtSearchIndex(const QwtData &data, bool xValues,
+    bool ascending, bool upper, double value, int from, int to)
+{
+    int lo = from;
+    int hi = to + 1;
+
+    while ( lo < hi )
     {
-        if ( event->type() == QEvent::Paint )
+        const int mid = lo + ( hi - lo ) / 2;
+        const double v = xValues ? data.x(mid) : data.y(mid);
+
+        bool inFront;
+        if ( ascending )
+            inFront = upper ? v <= value : v < value;
+        else
+            inFront = upper ? v >= value : v > value;
+
+        if ( inFront )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/*
+  Map the points [from, from + size[ of a block into
+  paint device coordinates
+ */
+static void qwtMapPoints(const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtDataBlock &block, int from, int size, QPointF *points)
+{
+    if ( size <= 0 )
+        return;
+
+    if ( sizeof(qreal) == sizeof(double) )
+    {
+        // transforming x and y into the interleaved coordinates
+        double *values = reinterpret_cast<double *>(points);
+        const size_t stride = block.stride();
+
+        xMap.xTransform(block.xData() + from * stride,
+            values, size, stride, 2);
+        yMap.xTransform(block.yData() + from * stride,
+            values + 1, size, stride, 2);
+    }
+    else
+    {
+        for ( int i = 0; i < size; i++ )
         {
-            _curve->draw(_from, _to);
-            return true;
+            points[i] = QPointF(xMap.xTransform(block.x(from + i)),
+                yMap.xTransform(block.y(from + i)));
         }
-        return false;
     }
-private:
-    const QwtPlotCurve *_curve;
-    int _from;
-    int _to;
-};
+}
+
+/*
+  Map the points of a block and reduce the points of each pixel column
+  ( row for !vertical ) to the first, the minimum, the maximum and
+  the last point of the column.
+ */
+static void qwtReduceColumns(QwtColumnReducer &reducer, bool vertical,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtDataBlock &block)
+{
+    const int chunkSize = 512;
+    QPointF points[chunkSize];
 
-// Creating and initializing a QPainter is an
-// expensive operation. So we keep an painter
-// open for situations, where we paint outside
-// of paint events. This improves the performance
-// of incremental painting like in the realtime
-// example a lot.
-// But it is not possible to have more than
-// one QPainter open at the same time. So we
-// need to close it before regular paint events
-// are processed.
+    const int size = block.size();
+    for ( int i = 0; i < size; i += chunkSize )
+    {
+        const int n = qwtMin(size - i, chunkSize);
+        qwtMapPoints(xMap, yMap, block, i, n, points);
 
-class QwtGuardedPainter: public QObject
+        for ( int j = 0; j < n; j++ )
+        {
+            const QPointF &pos = points[j];
+
+            if ( vertical )
+                reducer.append(::floor(pos.x()), pos.y(), pos);
+            else
+                reducer.append(::floor(pos.y()), pos.x(), pos);
+        }
+    }
+}
+
+// minimum number of points, that justifies an additional thread
+static const int qwtMinChunkSize = 16384;
+
+/*
+  Maximum number of points of a QwtDataBlock. Data without direct
+  memory access, like a file of floats, is copied into the buffer
+  of the block, so large ranges are processed block by block.
+ */
+static const int qwtMaxBlockSize = 4096;
+
+/*
+  Remove consecutive duplicates from points and
+  return the number of remaining points
+ */
+static int qwtRemoveDuplicates(QPointF *points, int size)
 {
-public:
-    ~QwtGuardedPainter()
+    if ( size <= 0 )
+        return 0;
+
+    int count = 1;
+    for ( int i = 1; i < size; i++ )
     {
-        end();
+        if ( points[i] != points[count - 1] )
+            points[count++] = points[i];
     }
 
-    QPainter *begin(QwtPlotCanvas *canvas)
+    return count;
+}
+
+/*
+  Map the points [from, from + size[ of data into a polyline.
+  filter might be QwtPlotCurve::PaintFiltered to remove consecutive
+  duplicates, QwtPlotCurve::PaintDecimated to reduce the points
+  of each pixel column or 0.
+
+  When multiThreaded is set, the points are split into chunks,
+  that are processed on the thread pool. The results of the
+  chunks are stitched together, so that the polyline is the same
+  as being built in one pass.
+ */
+static void qwtBuildPolyline(const QwtScaleMap &xMap,
+    const QwtScaleMap &yMap, const QwtData &data, int from, int size,
+    int filter, bool vertical, bool multiThreaded, QwtPolygonF &polyline)
+{
+    polyline.resize(0);
+    if ( size <= 0 )
+        return;
+
+    QwtReplotStatistics::addPointsTransformed(size);
+
+    const int numChunks = multiThreaded
+        ? QwtParallel::chunkCount(size, qwtMinChunkSize) : 1;
+    const int chunkSize = ( size + numChunks - 1 ) / numChunks;
+
+    if ( filter == QwtPlotCurve::PaintDecimated )
     {
-        _canvas = canvas;
+        QwtArray<QwtPolygonF> chunks(numChunks);
+        QwtPolygonF *chunkPolylines = chunks.data();
+
+        QwtParallel::run(numChunks, [&](int chunk)
+        {
+            const int i0 = chunk * chunkSize;
+            const int n = qwtMin(chunkSize, size - i0);
+
+            QwtColumnReducer reducer(chunkPolylines[chunk]);
+
+            for ( int i = 0; i < n; i += qwtMaxBlockSize )
+            {
+                const QwtDataBlock block(data, from + i0 + i,
+                    qwtMin(qwtMaxBlockSize, n - i));
+
+                qwtReduceColumns(reducer, vertical, xMap, yMap, block);
+            }
+        });
 
-        QMap<QwtPlotCanvas *, QPainter *>::iterator it = _map.find(_canvas);
-        if ( it == _map.end() )
+        if ( numChunks == 1 )
+        {
+            polyline = chunks[0];
+        }
+        else
         {
-            QPainter *painter = new QPainter(_canvas);
-            painter->setClipping(true);
-            painter->setClipRect(_canvas->contentsRect());
+            // pixel columns might be split at the chunk boundaries
+
+            QwtColumnReducer reducer(polyline);
+            for ( int chunk = 0; chunk < numChunks; chunk++ )
+            {
+                const QwtPolygonF &points = chunks[chunk];
+                for ( int i = 0; i < int(points.size()); i++ )
+                {
+                    const QPointF &pos = points[i];
 
-            it = _map.insert(_canvas, painter);
-            _canvas->installEventFilter(this);
+                    if ( vertical )
+                        reducer.append(::floor(pos.x()), pos.y(), pos);
+                    else
+                        reducer.append(::floor(pos.y()), pos.x(), pos);
+                }
+            }
         }
-        return it.value();
+
+        return;
     }
 
-    void end()
+    polyline.resize(size);
+    QPointF *points = polyline.data();
+
+    QwtArray<int> counts(numChunks);
+    int *chunkCounts = counts.data();
+
+    QwtParallel::run(numChunks, [&](int chunk)
     {
-        if ( _canvas )
+        const int i0 = chunk * chunkSize;
+        const int n = qwtMin(chunkSize, size - i0);
+
+        chunkCounts[chunk] = 0;
+        if ( n <= 0 )
+            return;
+
+        for ( int i = 0; i < n; i += qwtMaxBlockSize )
         {
-            QMap<QwtPlotCanvas *, QPainter *>::iterator it = _map.find(_canvas);
-            if ( it != _map.end() )
+            const int m = qwtMin(qwtMaxBlockSize, n - i);
+
+            const QwtDataBlock block(data, from + i0 + i, m);
+            qwtMapPoints(xMap, yMap, block, 0, m, points + i0 + i);
+        }
+
+        if ( filter == QwtPlotCurve::PaintFiltered )
+            chunkCounts[chunk] = qwtRemoveDuplicates(points + i0, n);
+        else
+            chunkCounts[chunk] = n;
+    });
+
+    if ( filter == QwtPlotCurve::PaintFiltered )
+    {
+        int count = chunkCounts[0];
+
+        for ( int chunk = 1; chunk < numChunks; chunk++ )
+        {
+            const QPointF *p = points + chunk * chunkSize;
+            int n = chunkCounts[chunk];
+
+            // a duplicate at the chunk boundary
+            if ( n > 0 && p[0] == points[count - 1] )
             {
-                _canvas->removeEventFilter(this);
-                delete it.value();
-                _map.erase(it);
+                p++;
+                n--;
             }
+
+            for ( int i = 0; i < n; i++ )
+                points[count++] = p[i];
         }
+
+        if ( count != size )
+            polyline.resize(count);
     }
+}
+
+static inline void qwtIncrement(quint32 &count)
+{
+    count++;
+}
 
-    virtual bool eventFilter(QObject *, QEvent *event)
+/*
+  The counts are only read, when all threads have finished. So the
+  increments don't need to be ordered with any other memory operation.
+ */
+static inline void qwtIncrement(std::atomic<quint32> &count)
+{
+    count.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*
+  Count the points [from, from + size[ of data, that are mapped to each
+  pixel of rect. Counter is quint32, or an atomic counter, when several
+  threads count into the same buffer.
+ */
+template <typename Counter>
+static void qwtCountHits(const QwtScaleMap &xMap,
+    const QwtScaleMap &yMap, const QwtData &data, int from, int size,
+    const QRect &rect, Counter *counts)
+{
+    if ( size <= 0 )
+        return;
+
+    const int width = rect.width();
+    const int height = rect.height();
+
+    // the points are mapped in blocks to limit the memory
+
+    QwtPolygonF points(qwtMin(qwtMaxBlockSize, size));
+
+    const double x1 = rect.left() - 0.5;
+    const double y1 = rect.top() - 0.5;
+
+    for ( int i = 0; i < size; i += qwtMaxBlockSize )
     {
-        if ( event->type() == QEvent::Paint )
-            end();
+        const int n = qwtMin(qwtMaxBlockSize, size - i);
 
-        return false;
+        const QwtDataBlock block(data, from + i, n);
+        qwtMapPoints(xMap, yMap, block, 0, n, points.data());
+
+        for ( int j = 0; j < n; j++ )
+        {
+            const double x = points[j].x() - x1;
+            const double y = points[j].y() - y1;
+
+            // also sorts out NaNs
+            if ( x >= 0.0 && x < width && y >= 0.0 && y < height )
+                qwtIncrement(counts[int(y) * width + int(x)]);
+        }
     }
+}
 
-private:
-    QPointer<QwtPlotCanvas> _canvas;
-    static QMap<QwtPlotCanvas *, QPainter *> _map;
-};
+/*
+  Map the counts into colors. The counts are mapped logarithmically,
+  so that sparse regions remain visible next to crowded ones.
+  Pixels without any point remain transparent.
+ */
+template <typename Counter>
+static void qwtPaintHits(const Counter *counts,
+    const QwtColorMap &colorMap, QImage &image)
+{
+    const int width = image.width();
+    const int height = image.height();
+    const int numPixels = width * height;
 
-QMap<QwtPlotCanvas *, QPainter *> QwtGuardedPainter::_map;
+    quint32 maxCount = 0;
+    for ( int i = 0; i < numPixels; i++ )
+        maxCount = qwtMax(maxCount, quint32(counts[i]));
 
-static int verifyRange(int size, int &i1, int &i2)
+    if ( maxCount == 0 )
+        return;
+
+    const QVector<QRgb> colorTable =
+        colorMap.colorTable(QwtDoubleInterval(0.0, 1.0));
+
+    const double logMax = ::log(double(maxCount));
+
+    for ( int y = 0; y < height; y++ )
+    {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        const Counter *c = counts + y * width;
+
+        for ( int x = 0; x < width; x++ )
+        {
+            const quint32 count = c[x];
+            if ( count > 0 )
+            {
+                int index = 255;
+                if ( logMax > 0.0 )
+                    index = qRound(255.0 * ::log(double(count)) / logMax);
+
+                line[x] = colorTable[index];
+            }
+        }
+    }
+}
+
+/*
+  Count the points [from, from + size[ of data, that are mapped to each
+  pixel of rect, and map the counts into colors.
+
+  When multiThreaded is set, the chunks of points are counted on the
+  thread pool into one buffer of atomic counters.
+ */
+static QImage qwtDensityImage(const QwtScaleMap &xMap,
+    const QwtScaleMap &yMap, const QwtData &data, int from, int size,
+    const QRect &rect, const QwtColorMap &colorMap, bool multiThreaded)
 {
-    if (size < 1)
-        return 0;
+    const int width = rect.width();
+    const int height = rect.height();
+    const int numPixels = width * height;
 
-    i1 = qwtLim(i1, 0, size-1);
-    i2 = qwtLim(i2, 0, size-1);
+    QImage image(width, height, QImage::Format_ARGB32);
+    image.fill(0);
 
-    if ( i1 > i2 )
-        qSwap(i1, i2);
+    if ( size <= 0 || numPixels <= 0 )
+        return image;
 
-    return (i2 - i1 + 1);
+    const int numChunks = multiThreaded
+        ? QwtParallel::chunkCount(size, qwtMinChunkSize) : 1;
+
+    if ( numChunks <= 1 )
+    {
+        QVector<quint32> counts(numPixels, 0);
+
+        qwtCountHits(xMap, yMap, data, from, size, rect, counts.data());
+        qwtPaintHits(counts.constData(), colorMap, image);
+    }
+    else
+    {
+        const int chunkSize = ( size + numChunks - 1 ) / numChunks;
+
+        std::atomic<quint32> *counts = new std::atomic<quint32>[numPixels];
+        for ( int i = 0; i < numPixels; i++ )
+            counts[i].store(0, std::memory_order_relaxed);
+
+        QwtParallel::run(numChunks, [&](int chunk)
+        {
+            const int i0 = chunk * chunkSize;
+            const int n = qwtMin(chunkSize, size - i0);
+
+            qwtCountHits(xMap, yMap, data, from + i0, n, rect, counts);
+        });
+
+        qwtPaintHits(counts, colorMap, image);
+
+        delete[] counts;
+    }
+
+    return image;
 }
 
 class QwtPlotCurve::PrivateData
 {
 public:
-    class PixelMatrix: private QBitArray
+    /*
+      One bit for each pixel of the canvas, packed into words
+     */
+    class PixelMatrix
     {
     public:
         PixelMatrix(const QRect& rect):
-            QBitArray(rect.width() * rect.height()),
-            _rect(rect)
+            _rect(rect),
+            _words((qwtMax(rect.width(), 0) *
+                qwtMax(rect.height(), 0) + 31) / 32, 0)
         {
-            fill(false);
+            _bits = _words.data();
         }
 
         inline bool testPixel(const QPoint& pos)
         {
-            if ( !_rect.contains(pos) )
+            // negative offsets wrap around to large unsigned values
+            const uint x = uint(pos.x() - _rect.x());
+            const uint y = uint(pos.y() - _rect.y());
+            if ( x >= uint(_rect.width()) || y >= uint(_rect.height()) )
                 return false;
 
-            const int idx = _rect.width() * (pos.y() - _rect.y()) +
-                (pos.x() - _rect.x());
+            const uint idx = y * uint(_rect.width()) + x;
 
-            const bool marked = testBit(idx);
-            if ( !marked )
-                setBit(idx, true);
+            quint32 &word = _bits[idx >> 5];
+            const quint32 mask = quint32(1) << ( idx & 31 );
+            if ( word & mask )
+                return false;
 
-            return !marked;
+            word |= mask;
+            return true;
         }
 
     private:
         QRect _rect;
+        QVector<quint32> _words;
+        quint32 *_bits;
+    };
+
+    /*
+      The result of the curve fitter. Depending on the fitter
+      and the maps, it is in scale or paint device coordinates.
+     */
+    class FittedCurve
+    {
+    public:
+        FittedCurve():
+            valid(false),
+            inScale(false),
+            fitter(nullptr),
+            revision(0),
+            from(0),
+            size(0),
+            dataSize(0)
+        {
+        }
+
+        bool valid;
+        bool inScale;
+
+        const QwtCurveFitter *fitter;
+        int revision;
+
+        int from;
+        int size;
+        size_t dataSize;
+
+        QwtScaleMap xMap;
+        QwtScaleMap yMap;
+
+        QPolygonF points;
     };
 
     PrivateData():
@@ -170,17 +597,418 @@ public:
         style(QwtPlotCurve::Lines),
         reference(0.0),
         attributes(0),
-        paintAttributes(0)
+        paintAttributes(0),
+        pyramid(nullptr),
+        spatialIndexEnabled(false),
+        spatialIndex(nullptr),
+        indexedSize(0),
+        dataOrder(QwtPlotCurve::DetectOrder),
+        orderedSize(0),
+        ascending(true),
+        descending(true),
+        syncedSize(0),
+        syncedAppendCount(0),
+        paintedAppendCount(0),
+        paintedSize(0)
     {
         symbol = new QwtSymbol();
         pen = QPen(Qt::black);
         curveFitter = new QwtSplineCurveFitter;
+        colorMap = new QwtLinearColorMap();
     }
 
     ~PrivateData()
     {
         delete symbol;
         delete curveFitter;
+        delete colorMap;
+        delete pyramid;
+        delete spatialIndex;
+    }
+
+    void invalidateCache()
+    {
+        if ( pyramid )
+            pyramid->invalidate();
+
+        if ( spatialIndex )
+            spatialIndex->reset();
+
+        indexedSize = 0;
+        orderedSize = 0;
+
+        fittedCurve = FittedCurve();
+
+        syncedSize = 0;
+        syncedAppendCount = 0;
+    }
+
+    /*
+      The caches are updated incrementally, as long as points have
+      only been appended. But streaming data, like a ring buffer,
+      drops points from its beginning ( see QwtData::appendCount() ).
+     */
+    void syncCache(const QwtData &data)
+    {
+        const size_t size = data.size();
+        const size_t appendCount = data.appendCount();
+
+        if ( appendCount < size )
+            return;
+
+        if ( appendCount < syncedAppendCount )
+        {
+            // the data has been replaced
+            invalidateCache();
+        }
+        else
+        {
+            const size_t numDropped = syncedSize
+                + ( appendCount - syncedAppendCount ) - size;
+
+            if ( numDropped > 0 )
+            {
+                // The pyramid aligns its buckets to the appended points
+                // and the detected order is still valid for the remaining
+                // points. A series, that is not ordered, stays unordered
+                // until its points are invalidated.
+
+                orderedSize -= qwtMin(orderedSize, numDropped);
+
+                if ( spatialIndex )
+                    spatialIndex->reset();
+                indexedSize = 0;
+
+                fittedCurve = FittedCurve();
+            }
+        }
+
+        syncedSize = size;
+        syncedAppendCount = appendCount;
+    }
+
+    QwtPlotCurve::DataOrder order(const QwtData &data)
+    {
+        if ( dataOrder != QwtPlotCurve::DetectOrder )
+            return dataOrder;
+
+        const size_t size = data.size();
+        if ( size < orderedSize )
+            orderedSize = 0;
+
+        if ( orderedSize == 0 )
+            ascending = descending = true;
+
+        // only the points, that have been appended need to be checked
+        size_t from = orderedSize > 0 ? orderedSize - 1 : 0;
+
+        while ( from + 1 < size && ( ascending || descending ) )
+        {
+            const size_t n = qwtMin(size - from, size_t(4096));
+            const QwtDataBlock block(data, from, n);
+
+            for ( size_t i = 1; i < n; i++ )
+            {
+                double v1, v2;
+                if ( curveType == QwtPlotCurve::Yfx )
+                {
+                    v1 = block.x(i - 1);
+                    v2 = block.x(i);
+                }
+                else
+                {
+                    v1 = block.y(i - 1);
+                    v2 = block.y(i);
+                }
+
+                if ( v2 < v1 )
+                    ascending = false;
+                else if ( v2 > v1 )
+                    descending = false;
+            }
+
+            from += n - 1;
+        }
+
+        orderedSize = size;
+
+        if ( ascending )
+            return QwtPlotCurve::AscendingOrder;
+        if ( descending )
+            return QwtPlotCurve::DescendingOrder;
+
+        return QwtPlotCurve::NoOrder;
+    }
+
+    void cullRange(const QwtData &data,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        int &from, int &to)
+    {
+        const QwtPlotCurve::DataOrder order = this->order(data);
+        if ( order != QwtPlotCurve::AscendingOrder &&
+            order != QwtPlotCurve::DescendingOrder )
+        {
+            return;
+        }
+
+        const bool yfx = curveType == QwtPlotCurve::Yfx;
+        const QwtScaleMap &map = yfx ? xMap : yMap;
+
+        // symbols of points outside might reach into the canvas
+        double margin = 0.0;
+        if ( symbol->style() != QwtSymbol::NoSymbol )
+        {
+            const QSize size =
+                QwtPainter::metricsMap().screenToLayout(symbol->size());
+
+            margin = 0.5 * ( yfx ? size.width() : size.height() )
+                + symbol->pen().width() + 1;
+        }
+
+        double v1 = map.invTransform(qwtMin(map.p1(), map.p2()) - margin);
+        double v2 = map.invTransform(qwtMax(map.p1(), map.p2()) + margin);
+        if ( v1 > v2 )
+            qSwap(v1, v2);
+
+        const bool asc = order == QwtPlotCurve::AscendingOrder;
+
+        const int first = qwtSearchIndex(data, yfx, asc, false,
+            asc ? v1 : v2, from, to);
+        const int last = qwtSearchIndex(data, yfx, asc, true,
+            asc ? v2 : v1, from, to);
+
+        // one point of overlap to connect the lines
+
+        from = qwtMax(first - 1, from);
+        to = qwtMin(last, to);
+    }
+
+    QwtArray<QwtDoublePoint> levelOfDetail(const QwtData &data,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap, int from, int to)
+    {
+        const Qt::Orientation orientation =
+            curveType == QwtPlotCurve::Yfx ? Qt::Vertical : Qt::Horizontal;
+
+        if ( pyramid == nullptr )
+            pyramid = new QwtDataPyramid(orientation);
+        else
+            pyramid->setOrientation(orientation);
+
+        // we assume, that points have been appended, or dropped from
+        // the beginning of streaming data. Otherwise the pyramid has
+        // been invalidated.
+
+        pyramid->update(data, pyramid->dataSize());
+
+        return pyramid->points(data,
+            orientation == Qt::Vertical ? xMap : yMap, from, to);
+    }
+
+    /*
+      With CacheFitted the fitted curve is kept. When the fitter is
+      affine invariant for the points and the maps are linear, they are
+      fitted in scale coordinates and the result can be reused for
+      other maps. Otherwise it is only valid for the same maps.
+     */
+    QPolygonF fitted(const QwtData &data,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        int from, int size, bool cached, bool multiThreaded)
+    {
+        // the order of the x coordinates has to be preserved
+
+        const bool linear = qwtIsLinear(xMap) && qwtIsLinear(yMap) &&
+            ( xMap.p2() - xMap.p1() ) * ( xMap.s2() - xMap.s1() ) > 0.0;
+
+        FittedCurve uncached;
+        FittedCurve &fc = cached ? fittedCurve : uncached;
+
+        bool valid = fc.valid && fc.fitter == curveFitter &&
+            fc.revision == curveFitter->revision() &&
+            fc.from == from && fc.size == size &&
+            fc.dataSize == data.size();
+
+        if ( valid )
+        {
+            if ( fc.inScale )
+                valid = linear;
+            else
+                valid = qwtSameMap(xMap, fc.xMap) && qwtSameMap(yMap, fc.yMap);
+        }
+
+        if ( !valid )
+        {
+            QPolygonF points;
+
+            bool inScale = false;
+            if ( linear )
+            {
+                points.resize(size);
+                for ( int i = 0; i < size; i += qwtMaxBlockSize )
+                {
+                    const int n = qwtMin(qwtMaxBlockSize, size - i);
+
+                    const QwtDataBlock block(data, from + i, n);
+                    for ( int j = 0; j < n; j++ )
+                        points[i + j] = QPointF(block.x(j), block.y(j));
+                }
+
+                inScale = curveFitter->isAffineInvariant(points);
+            }
+
+            if ( !inScale )
+            {
+                // Transform x and y values to window coordinates
+                // to avoid a distinction between linear and
+                // logarithmic scales.
+
+                qwtBuildPolyline(xMap, yMap, data, from, size, 0,
+                    curveType == QwtPlotCurve::Yfx, multiThreaded, points);
+            }
+
+            fc.points = curveFitter->fitCurve(points);
+
+            fc.valid = true;
+            fc.inScale = inScale;
+            fc.fitter = curveFitter;
+            fc.revision = curveFitter->revision();
+            fc.from = from;
+            fc.size = size;
+            fc.dataSize = data.size();
+            fc.xMap = xMap;
+            fc.yMap = yMap;
+        }
+
+        if ( !fc.inScale )
+            return fc.points;
+
+        const QwtPolygonFData fittedData(fc.points);
+
+        QPolygonF points;
+        qwtBuildPolyline(xMap, yMap, fittedData, 0, fc.points.size(), 0,
+            curveType == QwtPlotCurve::Yfx, multiThreaded, points);
+
+        return points;
+    }
+
+    /*
+      Draw the parts of the polyline, that are inside of the canvas.
+      The buffers for the clipped runs are reused for each replot.
+     */
+    void drawClipped(QPainter *painter, const QwtPolygonF &polyline)
+    {
+        QwtClipper::clipPolyline(QwtDoubleRect(canvasRect),
+            polyline, clippedPoints, clippedRuns);
+
+        QwtReplotStatistics::addPointsPainted(clippedPoints.size());
+
+        const QPointF *points = clippedPoints.constData();
+        for ( int i = 0; i < clippedRuns.size(); i++ )
+        {
+            QwtPainter::drawPolyline(painter, points, clippedRuns[i]);
+            points += clippedRuns[i];
+        }
+    }
+
+    /*
+      The index is rebuilt completely, when the size of the data
+      has changed. Without an index the queries iterate over the data.
+     */
+    const QwtSpatialIndex *index(const QwtData &data)
+    {
+        if ( !spatialIndexEnabled )
+            return nullptr;
+
+        if ( spatialIndex == nullptr )
+            spatialIndex = new QwtSpatialIndex();
+
+        if ( indexedSize != data.size() )
+        {
+            spatialIndex->setData(data);
+            indexedSize = data.size();
+        }
+
+        return spatialIndex;
+    }
+
+    /*
+      Bounding rectangle of the pixels, that are painted
+      for the points [from, to]
+     */
+    QRect paintRect(const QwtData &data,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        int from, int to) const
+    {
+        QRectF rect;
+
+        QwtPolygonF points;
+        for ( int i = from; i <= to; i += qwtMaxBlockSize )
+        {
+            const int n = qwtMin(qwtMaxBlockSize, to - i + 1);
+
+            const QwtDataBlock block(data, i, n);
+
+            points.resize(n);
+            qwtMapPoints(xMap, yMap, block, 0, n, points.data());
+
+            const QRectF br = points.boundingRect();
+            if ( i == from )
+            {
+                rect = br;
+            }
+            else
+            {
+                rect.setLeft(qwtMin(rect.left(), br.left()));
+                rect.setTop(qwtMin(rect.top(), br.top()));
+                rect.setRight(qwtMax(rect.right(), br.right()));
+                rect.setBottom(qwtMax(rect.bottom(), br.bottom()));
+            }
+        }
+
+        return paintRect(rect, xMap, yMap);
+    }
+
+    /*
+      Extend the bounding rectangle of mapped points by the baseline
+      and the extent of pen and symbol
+     */
+    QRect paintRect(QRectF rect,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap) const
+    {
+        if ( style == QwtPlotCurve::Sticks || brush.style() != Qt::NoBrush )
+        {
+            // sticks and the filling reach to the baseline
+
+            if ( curveType == QwtPlotCurve::Yfx )
+            {
+                const double y0 =
+                    qwtLim(yMap.xTransform(reference), -1e9, 1e9);
+                rect.setTop(qwtMin(rect.top(), y0));
+                rect.setBottom(qwtMax(rect.bottom(), y0));
+            }
+            else
+            {
+                const double x0 =
+                    qwtLim(xMap.xTransform(reference), -1e9, 1e9);
+                rect.setLeft(qwtMin(rect.left(), x0));
+                rect.setRight(qwtMax(rect.right(), x0));
+            }
+        }
+
+        int margin = QwtPainter::scaledPen(pen).width();
+        if ( symbol->style() != QwtSymbol::NoSymbol )
+        {
+            const QSize size =
+                QwtPainter::metricsMap().screenToLayout(symbol->size());
+
+            margin = qwtMax(margin, qwtMax(size.width(), size.height()) / 2
+                + QwtPainter::scaledPen(symbol->pen()).width());
+        }
+
+        // 1 pixel for rounding and antialiasing
+        margin += 1;
+
+        return rect.toAlignedRect().adjusted(
+            -margin, -margin, margin, margin);
     }
 
     QwtPlotCurve::CurveType curveType;
@@ -189,6 +1017,7 @@ public:
 
     QwtSymbol *symbol;
     QwtCurveFitter *curveFitter;
+    QwtColorMap *colorMap;
 
     QPen pen;
     QBrush brush;
@@ -196,9 +1025,34 @@ public:
     int attributes;
     int paintAttributes;
 
-    QwtGuardedPainter guardedPainter;
+    QwtDataPyramid *pyramid;
+
+    bool spatialIndexEnabled;
+    QwtSpatialIndex *spatialIndex;
+    size_t indexedSize;
+
+    FittedCurve fittedCurve;
+
+    QwtPlotCurve::DataOrder dataOrder;
+    size_t orderedSize;
+    bool ascending;
+    bool descending;
+
+    // state of a ring buffer, when the caches have been updated
+    size_t syncedSize;
+    size_t syncedAppendCount;
+
+    // the last complete paint, see drawAppended()
+    size_t paintedAppendCount;
+    size_t paintedSize;
+    QwtScaleMap paintedXMap;
+    QwtScaleMap paintedYMap;
 
 	QRect canvasRect; // temporary, while painting
+
+    // buffers of drawClipped()
+    QwtPolygonF clippedPoints;
+    QwtArray<int> clippedRuns;
 };
 
 //! Constructor
@@ -231,6 +1085,9 @@ QwtPlotCurve::QwtPlotCurve(const QString &title):
 //! Destructor
 QwtPlotCurve::~QwtPlotCurve()
 {
+    // the item might be painted by an asynchronous render
+    detach();
+
     delete d_xy;
     delete d_data;
 }
@@ -264,19 +1121,144 @@ int QwtPlotCurve::rtti() const
 */
 void QwtPlotCurve::setPaintAttribute(PaintAttribute attribute, bool on)
 {
+    waitForRender();
+
     if ( on )
         d_data->paintAttributes |= attribute;
     else
         d_data->paintAttributes &= ~attribute;
+
+    if ( attribute == CacheFitted && !on )
+        d_data->fittedCurve = PrivateData::FittedCurve();
+}
+
+/*!
+    \brief Return the current paint attributes
+    \sa PaintAttribute, setPaintAttribute()
+*/
+bool QwtPlotCurve::testPaintAttribute(PaintAttribute attribute) const
+{
+    return (d_data->paintAttributes & attribute);
+}
+
+/*!
+  \brief En/Disable the spatial index
+
+  closestPoint() and pointsInside() iterate over all points, what
+  takes O(n) for each call. With the spatial index enabled the points
+  are looked up in a QwtSpatialIndex, that is built, when it is needed
+  the first time after the data has been changed. Then a lookup takes
+  O(log(n)) on average.
+
+  The index is rebuilt, when the size of the data has changed.
+  When points have been modified otherwise without setData(),
+  like the memory of setRawData(), invalidateCache() has to be called.
+
+  The spatial index is disabled by default.
+
+  \param on Enable the index, when on is true
+  \sa spatialIndexEnabled(), closestPoint(), pointsInside(),
+      invalidateCache()
+*/
+void QwtPlotCurve::setSpatialIndexEnabled(bool on)
+{
+    if ( on == d_data->spatialIndexEnabled )
+        return;
+
+    waitForRender();
+
+    d_data->spatialIndexEnabled = on;
+    if ( !on )
+    {
+        delete d_data->spatialIndex;
+        d_data->spatialIndex = nullptr;
+        d_data->indexedSize = 0;
+    }
+}
+
+/*!
+  \return true, when the spatial index is enabled
+  \sa setSpatialIndexEnabled()
+*/
+bool QwtPlotCurve::spatialIndexEnabled() const
+{
+    return d_data->spatialIndexEnabled;
+}
+
+/*!
+  \brief Spatial index of the curve
+
+  The index is built or updated in the calling thread, that has to be
+  the GUI thread. A running asynchronous render, that might update the
+  caches of the curve, is completed before. The queries of the returned
+  index only read it, so they can run concurrently in other threads
+  as long as the data of the curve is not modified.
+
+  \return Index, or nullptr when the spatial index is disabled
+  \sa setSpatialIndexEnabled(), QwtPlot::curvePointsInside()
+*/
+const QwtSpatialIndex *QwtPlotCurve::spatialIndex() const
+{
+    if ( !d_data->spatialIndexEnabled )
+        return nullptr;
+
+    waitForRender();
+
+    d_data->syncCache(*d_xy);
+    return d_data->index(*d_xy);
+}
+
+/*!
+  Assign the order of the points in x direction ( y for Xfy )
+
+  The order is needed for the PaintVisibleRange attribute.
+  When the order is known in advance, assigning it avoids
+  iterating over all points to detect it.
+
+  \param order Order of the points
+  \sa dataOrder(), PaintVisibleRange
+*/
+void QwtPlotCurve::setDataOrder(DataOrder order)
+{
+    if ( order != d_data->dataOrder )
+    {
+        waitForRender();
+
+        d_data->dataOrder = order;
+        itemChanged();
+    }
+}
+
+/*!
+  \return Order of the points
+  \sa setDataOrder()
+*/
+QwtPlotCurve::DataOrder QwtPlotCurve::dataOrder() const
+{
+    return d_data->dataOrder;
 }
 
 /*!
-    \brief Return the current paint attributes
-    \sa PaintAttribute, setPaintAttribute()
+  \brief Invalidate all information, that has been derived from the data
+
+  The curve caches the pyramid of the PaintLevelOfDetail attribute,
+  the detected order of the points for PaintVisibleRange, the fitted
+  curve of CacheFitted and the spatial index, when it is enabled.
+  They are updated, when points have been appended, and are reset by
+  setData(). When points have been modified in place otherwise,
+  the cache has to be invalidated.
+
+  \sa PaintLevelOfDetail, PaintVisibleRange, CacheFitted,
+      QwtDataPyramid, setSpatialIndexEnabled()
 */
-bool QwtPlotCurve::testPaintAttribute(PaintAttribute attribute) const
+void QwtPlotCurve::invalidateCache()
 {
-    return (d_data->paintAttributes & attribute);
+    waitForRender();
+
+    d_data->invalidateCache();
+
+    // the painted points are unknown, see drawAppended()
+    d_data->paintedSize = 0;
 }
 
 /*!
@@ -289,6 +1271,8 @@ void QwtPlotCurve::setStyle(CurveStyle style)
 {
     if ( style != d_data->style )
     {
+        waitForRender();
+
         d_data->style = style;
         itemChanged();
     }
@@ -310,6 +1294,8 @@ QwtPlotCurve::CurveStyle QwtPlotCurve::style() const
 */
 void QwtPlotCurve::setSymbol(const QwtSymbol &symbol )
 {
+    waitForRender();
+
     delete d_data->symbol;
     d_data->symbol = symbol.clone();
     itemChanged();
@@ -337,6 +1323,8 @@ void QwtPlotCurve::setPen(const QPen &pen)
 {
     if ( pen != d_data->pen )
     {
+        waitForRender();
+
         d_data->pen = pen;
         itemChanged();
     }
@@ -370,6 +1358,8 @@ void QwtPlotCurve::setBrush(const QBrush &brush)
 {
     if ( brush != d_data->brush )
     {
+        waitForRender();
+
         d_data->brush = brush;
         itemChanged();
     }
@@ -398,8 +1388,11 @@ const QBrush& QwtPlotCurve::brush() const
 */
 void QwtPlotCurve::setData(const double *xData, const double *yData, int size)
 {
+    waitForRender();
+
     delete d_xy;
     d_xy = new QwtArrayData(xData, yData, size);
+    invalidateCache();
     itemChanged();
 }
 
@@ -415,8 +1408,11 @@ void QwtPlotCurve::setData(const double *xData, const double *yData, int size)
 void QwtPlotCurve::setData(const QwtArray<double> &xData,
     const QwtArray<double> &yData)
 {
+    waitForRender();
+
     delete d_xy;
     d_xy = new QwtArrayData(xData, yData);
+    invalidateCache();
     itemChanged();
 }
 
@@ -428,8 +1424,11 @@ void QwtPlotCurve::setData(const QwtArray<double> &xData,
 */
 void QwtPlotCurve::setData(const QPolygonF &data)
 {
+    waitForRender();
+
     delete d_xy;
     d_xy = new QwtPolygonFData(data);
+    invalidateCache();
     itemChanged();
 }
 
@@ -441,8 +1440,11 @@ void QwtPlotCurve::setData(const QPolygonF &data)
 */
 void QwtPlotCurve::setData(const QwtData &data)
 {
+    waitForRender();
+
     delete d_xy;
     d_xy = data.copy();
+    invalidateCache();
     itemChanged();
 }
 
@@ -461,8 +1463,11 @@ void QwtPlotCurve::setData(const QwtData &data)
 */
 void QwtPlotCurve::setRawData(const double *xData, const double *yData, int size)
 {
+    waitForRender();
+
     delete d_xy;
     d_xy = new QwtCPointerData(xData, yData, size);
+    invalidateCache();
     itemChanged();
 }
 
@@ -480,6 +1485,46 @@ QwtDoubleRect QwtPlotCurve::boundingRect() const
     return d_xy->boundingRect();
 }
 
+/*!
+  \brief Area of the canvas, that is affected by painting the curve
+
+  Extends the mapped rectangle by the extent of pen and symbol,
+  and to the baseline for sticks and filled curves.
+  Fitted lines might overshoot the bounding rectangle of the
+  points, so the area is unknown for them.
+
+  \param xMap X map
+  \param yMap Y map
+  \param rect Bounding rectangle in scale coordinates
+
+  \return Rectangle in paint coordinates, or an invalid rectangle,
+          when the area is unknown.
+  \sa QwtPlotItem::damageRect(), boundingRect()
+*/
+QRect QwtPlotCurve::damageRect(const QwtScaleMap &xMap,
+    const QwtScaleMap &yMap, const QwtDoubleRect &rect) const
+{
+    if ( d_data->style == Lines && testCurveAttribute(Fitted) )
+        return QRect();
+
+    if ( !( rect.width() >= 0.0 && rect.height() >= 0.0 ) )
+        return QRect();
+
+    const double x1 = xMap.xTransform(rect.left());
+    const double x2 = xMap.xTransform(rect.right());
+    const double y1 = yMap.xTransform(rect.top());
+    const double y2 = yMap.xTransform(rect.bottom());
+
+    if ( !( qAbs(x1) < 1e9 && qAbs(x2) < 1e9 &&
+        qAbs(y1) < 1e9 && qAbs(y2) < 1e9 ) )
+    {
+        return QRect();
+    }
+
+    const QRectF mappedRect = QRectF(x1, y1, x2 - x1, y2 - y1).normalized();
+    return d_data->paintRect(mappedRect, xMap, yMap);
+}
+
 /*!
   \brief Draw the complete curve
 
@@ -496,80 +1541,170 @@ void QwtPlotCurve::draw(QPainter *painter,
 	d_data->canvasRect = canvasRect;
 	draw(painter, xMap, yMap, 0, -1);
 	d_data->canvasRect = QRect();
+
+    if ( d_xy->appendCount() >= d_xy->size() )
+    {
+        d_data->paintedAppendCount = d_xy->appendCount();
+        d_data->paintedSize = d_xy->size();
+        d_data->paintedXMap = xMap;
+        d_data->paintedYMap = yMap;
+    }
 }
 
 /*!
   \brief Draw a set of points of a curve.
 
   When observing an measurement while it is running, new points have to be
-  added to an existing curve. drawCurve can be used to display them avoiding
-  a complete redraw of the canvas.
+  added to an existing curve. draw(from, to) can be used to display them
+  avoiding a complete redraw of the canvas.
+
+  The points are painted into the paint cache of the canvas, and only
+  the rectangle covered by them is updated. No painting happens on the
+  widget outside of its paint event, so several calls before the next
+  paint event are flushed together.
 
-  Setting plot()->canvas()->setAttribute(Qt::WA_PaintOutsidePaintEvent, true);
-  will result in faster painting, if the paint engine of the canvas widget
-  supports this feature.
+  Without a paint cache ( see QwtPlotCanvas::PaintCached ) the
+  complete canvas has to be repainted.
 
   \param from Index of the first point to be painted
   \param to Index of the last point to be painted. If to < 0 the
          curve will be painted to its last point.
 
-  \sa drawCurve(), drawSymbols()
+  \sa drawAppended(), drawCurve(), drawSymbols(), QwtPlotCanvas::paintCache()
 */
 void QwtPlotCurve::draw(int from, int to) const
 {
-    if ( !plot() )
+    if ( !plot() || dataSize() <= 0 )
         return;
 
+    waitForRender();
+
     QwtPlotCanvas *canvas = plot()->canvas();
+    const QRect canvasRect = canvas->contentsRect();
 
-    if ( !canvas->testAttribute(Qt::WA_WState_InPaintEvent) && !canvas->testAttribute(Qt::WA_PaintOnScreen) )
+    QPixmap *cache = canvas->paintCache();
+    if ( !canvas->testPaintAttribute(QwtPlotCanvas::PaintCached) ||
+        cache == nullptr || cache->size() != canvasRect.size() ||
+        testItemAttribute(Overlay) )
     {
-        /*
-          We save curve and range in helper and call repaint.
-          The helper filters the Paint event, to repeat
-          the QwtPlotCurve::draw, but now from inside the paint
-          event.
-         */
-
-        QwtPlotCurvePaintHelper helper(this, from, to);
-        canvas->installEventFilter(&helper);
+        canvas->update(canvasRect);
+        return;
+    }
 
-        const bool noSystemBackground =
-            canvas->testAttribute(Qt::WA_NoSystemBackground);
-        canvas->setAttribute(Qt::WA_NoSystemBackground, true);
-        canvas->repaint();
-        canvas->setAttribute(Qt::WA_NoSystemBackground, noSystemBackground);
+    if (to < 0)
+        to = dataSize() - 1;
 
+    if ( verifyRange(dataSize(), from, to) <= 0 )
         return;
-    }
 
     const QwtScaleMap xMap = plot()->canvasMap(xAxis());
     const QwtScaleMap yMap = plot()->canvasMap(yAxis());
 
-    if ( canvas->testPaintAttribute(QwtPlotCanvas::PaintCached) &&
-        canvas->paintCache() && !canvas->paintCache()->isNull() )
+    d_data->canvasRect = canvasRect;
+
+    // a cached layer of the curve needs the points too
+
+    QImage *layer = canvas->layerCache(z());
+    if ( layer && layer->size() == canvasRect.size() )
     {
-        QPainter cachePainter((QPixmap *)canvas->paintCache());
-        cachePainter.translate(-canvas->contentsRect().x(),
-            -canvas->contentsRect().y());
+        QPainter layerPainter(layer);
+        layerPainter.translate(-canvasRect.x(), -canvasRect.y());
+        layerPainter.setClipRect(canvasRect);
 
-        draw(&cachePainter, xMap, yMap, from, to);
+        draw(&layerPainter, xMap, yMap, from, to);
     }
 
-    if ( canvas->testAttribute(Qt::WA_WState_InPaintEvent) )
+    QPainter painter(cache);
+    painter.translate(-canvasRect.x(), -canvasRect.y());
+    painter.setClipRect(canvasRect);
+
+    draw(&painter, xMap, yMap, from, to);
+    painter.end();
+
+    d_data->canvasRect = QRect();
+
+    // fitted curves are always painted completely
+
+    QRect updateRect = canvasRect;
+    if ( !( d_data->style == Lines && testCurveAttribute(Fitted) ) )
+        updateRect &= d_data->paintRect(*d_xy, xMap, yMap, from, to);
+
+    if ( updateRect.isValid() )
+        canvas->update(updateRect);
+}
+
+/*!
+  \brief Draw the points, that have been appended to the data
+         since the last time the curve has been painted
+
+  When the curve data supports appending ( see QwtData::appendCount() ),
+  like QwtRingBufferData, drawAppended() paints only the new points
+  ( plus one point of overlap to connect the lines ) using
+  draw(from, to), instead of replotting everything.
+
+  This is only possible as long as the canvas maps of the curve
+  are the same as for the last complete paint. When the axes have
+  been changed - or would be changed by autoscaling - the plot
+  needs to be replotted. The same is true, when points have been
+  dropped, like by a full ring buffer, as they would remain
+  on the canvas.
+
+  \return true, when the new points have been painted, 
+          false, when a replot is necessary.
+  \sa QwtRingBufferData, draw(int, int), QwtPlot::replot()
+*/
+bool QwtPlotCurve::drawAppended() const
+{
+    if ( plot() == nullptr )
+        return false;
+
+    // new points change the colors of the complete density image
+    if ( d_data->style == Density )
+        return false;
+
+    waitForRender();
+
+    const size_t appendCount = d_xy->appendCount();
+    const size_t size = d_xy->size();
+
+    // the data doesn't support appending or has been reset
+    if ( appendCount < size || appendCount < d_data->paintedAppendCount )
+        return false;
+
+    const size_t numPoints = appendCount - d_data->paintedAppendCount;
+    if ( numPoints == 0 )
+        return true;
+
+    // dropped points would remain on the canvas
+    if ( d_data->paintedSize == 0 ||
+        d_data->paintedSize + numPoints > size )
     {
-        QPainter painter(canvas);
+        return false;
+    }
 
-        painter.setClipping(true);
-        painter.setClipRect(canvas->contentsRect());
+    const QwtScaleMap xMap = plot()->canvasMap(xAxis());
+    const QwtScaleMap yMap = plot()->canvasMap(yAxis());
 
-        draw(&painter, xMap, yMap, from, to);
+    if ( !qwtSameMap(xMap, d_data->paintedXMap) || 
+        !qwtSameMap(yMap, d_data->paintedYMap) )
+    {
+        return false;
     }
-    else
+
+    if ( testItemAttribute(QwtPlotItem::AutoScale) &&
+        ( qwtAutoScaleChanged(plot(), xAxis()) ||
+            qwtAutoScaleChanged(plot(), yAxis()) ) )
     {
-        QPainter *painter = d_data->guardedPainter.begin(canvas);
-        draw(painter, xMap, yMap, from, to);
+        return false;
     }
+
+    const int to = int(size) - 1;
+    draw(qwtMax(to - int(numPoints), 0), to);
+
+    d_data->paintedAppendCount = appendCount;
+    d_data->paintedSize = size;
+
+    return true;
 }
 
 /*!
@@ -595,6 +1730,11 @@ void QwtPlotCurve::draw(QPainter *painter,
 
     if ( verifyRange(dataSize(), from, to) > 0 )
     {
+        d_data->syncCache(*d_xy);
+
+        if ( d_data->paintAttributes & PaintVisibleRange )
+            d_data->cullRange(*d_xy, xMap, yMap, from, to);
+
         painter->save();
         painter->setPen(QwtPainter::scaledPen(d_data->pen));
 
@@ -652,6 +1792,9 @@ void QwtPlotCurve::drawCurve(QPainter *painter, int style,
         case Dots:
             drawDots(painter, xMap, yMap, from, to);
             break;
+        case Density:
+            drawDensity(painter, xMap, yMap, from, to);
+            break;
         case NoCurve:
         default:
             break;
@@ -685,19 +1828,9 @@ void QwtPlotCurve::drawLines(QPainter *painter,
     QwtPolygonF polyline;
     if ( ( d_data->attributes & Fitted ) && d_data->curveFitter )
     {
-        // Transform x and y values to window coordinates
-        // to avoid a distinction between linear and
-        // logarithmic scales.
-
-        QPolygonF points(size);
-        for (int i = from; i <= to; i++)
-        {
-            QwtDoublePoint &p = points[i];
-            p.setX( xMap.xTransform(x(i)) );
-            p.setY( yMap.xTransform(y(i)) );
-        }
-
-        points = d_data->curveFitter->fitCurve(points);
+        const QPolygonF points = d_data->fitted(*d_xy, xMap, yMap,
+            from, size, d_data->paintAttributes & CacheFitted,
+            d_data->paintAttributes & PaintMultiThreaded);
         size = points.size();
 
         if ( size == 0 )
@@ -742,45 +1875,54 @@ void QwtPlotCurve::drawLines(QPainter *painter,
     }
     else
     {
-        polyline.resize(size);
+        const QwtData *data = d_xy;
 
-        if ( d_data->paintAttributes & PaintFiltered )
+        QwtPolygonFData reducedData = QwtPolygonF();
+        if ( d_data->paintAttributes & PaintLevelOfDetail )
         {
-            QPointF pp( xMap.xTransform(x(from)), yMap.xTransform(y(from)) );
-            polyline[0] = pp;
+            reducedData = QwtPolygonFData(
+                d_data->levelOfDetail(*d_xy, xMap, yMap, from, to));
 
-            int count = 1;
-            for (int i = from + 1; i <= to; i++)
-            {
-                const QPointF pi(xMap.xTransform(x(i)), yMap.xTransform(y(i)));
-                if ( pi != pp )
-                {
-                    polyline[count] = pi;
-                    count++;
+            data = &reducedData;
+            from = 0;
+            size = reducedData.size();
 
-                    pp = pi;
-                }
-            }
-            if ( count != size )
-                polyline.resize(count);
-        }
-        else
-        {
-            for (int i = from; i <= to; i++)
-            {
-                const QPointF pi(xMap.xTransform(x(i)), yMap.xTransform(y(i)));
-                polyline[i - from] = pi;
-            }
+            if ( size == 0 )
+                return;
         }
+
+        int filter = 0;
+        if ( d_data->paintAttributes & PaintDecimated )
+            filter = PaintDecimated;
+        else if ( d_data->paintAttributes & PaintFiltered )
+            filter = PaintFiltered;
+
+        qwtBuildPolyline(xMap, yMap, *data, from, size, filter,
+            d_data->curveType == Yfx,
+            d_data->paintAttributes & PaintMultiThreaded, polyline);
     }
 
-	if ( d_data->canvasRect.isValid() && d_data->paintAttributes & ClipPolygons )
-		polyline = QwtClipper::clipPolygonF(d_data->canvasRect, polyline);
+    const bool doClip = d_data->canvasRect.isValid() &&
+        (d_data->paintAttributes & ClipPolygons);
 
-    QwtPainter::drawPolyline(painter, polyline);
+    if ( doClip )
+    {
+        d_data->drawClipped(painter, polyline);
+    }
+    else
+    {
+        QwtReplotStatistics::addPointsPainted(polyline.size());
+        QwtPainter::drawPolyline(painter, polyline);
+    }
 
     if ( d_data->brush.style() != Qt::NoBrush )
+    {
+        // the filled area needs to be closed along the borders
+        if ( doClip )
+            polyline = QwtClipper::clipPolygonF(d_data->canvasRect, polyline);
+
         fillCurve(painter, xMap, yMap, polyline);
+    }
 }
 
 /*!
@@ -801,10 +1943,19 @@ void QwtPlotCurve::drawSticks(QPainter *painter,
     int x0 = xMap.transform(d_data->reference);
     int y0 = yMap.transform(d_data->reference);
 
-    for (int i = from; i <= to; i++)
+    const int size = to - from + 1;
+
+    QwtPolygonF points;
+    qwtBuildPolyline(xMap, yMap, *d_xy, from, size, 0,
+        d_data->curveType == Yfx,
+        d_data->paintAttributes & PaintMultiThreaded, points);
+
+    QwtReplotStatistics::addPointsPainted(2 * size);
+
+    for (int i = 0; i < size; i++)
     {
-        const int xi = xMap.transform(x(i));
-        const int yi = yMap.transform(y(i));
+        const int xi = qRound(points[i].x());
+        const int yi = qRound(points[i].y());
 
         if (d_data->curveType == Xfy)
             QwtPainter::drawLine(painter, x0, yi, xi, yi);
@@ -829,73 +1980,85 @@ void QwtPlotCurve::drawDots(QPainter *painter,
     int from, int to) const
 {
     const bool doFill = d_data->brush.style() != Qt::NoBrush;
+    const bool doFilter =
+        to > from && ( d_data->paintAttributes & PaintFiltered );
 
-    QwtPolygonF polyline;
-    if ( doFill )
-        polyline.resize(to - from + 1);
+    // if we don't need to fill, we can sort out
+    // duplicates independent from the order
 
-    if ( to > from && d_data->paintAttributes & PaintFiltered )
-    {
-		if ( doFill || d_data->canvasRect.isEmpty() )
-        {
-            QPointF pp( xMap.xTransform(x(from)), yMap.xTransform(y(from)) );
+    const bool doMatrix =
+        doFilter && !doFill && !d_data->canvasRect.isEmpty();
 
-            QwtPainter::drawPoint(painter, pp.x(), pp.y());
-            polyline[0] = pp;
+    QwtPolygonF points;
+    qwtBuildPolyline(xMap, yMap, *d_xy, from, to - from + 1,
+        ( doFilter && !doMatrix ) ? PaintFiltered : 0,
+        d_data->curveType == Yfx,
+        d_data->paintAttributes & PaintMultiThreaded, points);
 
-            int count = 1;
-            for (int i = from + 1; i <= to; i++)
-            {
-                const QPointF pi(xMap.xTransform(x(i)), yMap.xTransform(y(i)));
-                if ( pi != pp )
-                {
-                    QwtPainter::drawPoint(painter, pi.x(), pi.y());
+    int numPoints = points.size();
 
-                    polyline[count] = pi;
-                    count++;
+    if ( doMatrix )
+    {
+        PrivateData::PixelMatrix pixelMatrix(d_data->canvasRect);
 
-                    pp = pi;
-                }
-            }
-            if ( int(polyline.size()) != count )
-                polyline.resize(count);
-        }
-        else
+        numPoints = 0;
+        for (int i = 0; i < points.size(); i++)
         {
-            // if we don't need to fill, we can sort out
-            // duplicates independent from the order
-
-			PrivateData::PixelMatrix pixelMatrix(d_data->canvasRect);
-
-            for (int i = from; i <= to; i++)
-            {
-                const QPointF p( xMap.xTransform(x(i)), yMap.xTransform(y(i)) );
-
-                if ( pixelMatrix.testPixel(p.toPoint()) )
-                    QwtPainter::drawPoint(painter, p.x(), p.y());
-            }
+            if ( pixelMatrix.testPixel(points[i].toPoint()) )
+                points[numPoints++] = points[i];
         }
     }
-    else
-    {
-        for (int i = from; i <= to; i++)
-        {
-            const double xi = xMap.xTransform(x(i));
-            const double yi = yMap.xTransform(y(i));
-            QwtPainter::drawPoint(painter, xi, yi);
 
-            if ( doFill )
-                polyline[i - from] = QPointF(xi, yi);
-        }
-    }
+    QwtReplotStatistics::addPointsPainted(numPoints);
+    QwtPainter::drawPoints(painter, points.constData(), numPoints);
 
     if ( doFill )
     {
 		if ( d_data->canvasRect.isValid() && (d_data->paintAttributes & ClipPolygons) )
-			polyline = QwtClipper::clipPolygonF(d_data->canvasRect, polyline);
+			points = QwtClipper::clipPolygonF(d_data->canvasRect, points);
 
-        fillCurve(painter, xMap, yMap, polyline);
+        fillCurve(painter, xMap, yMap, points);
+    }
+}
+
+/*!
+  Draw the density of the points
+
+  The points are counted for each pixel of the canvas and painted
+  as an image, that is colored by the color map.
+
+  \param painter Painter
+  \param xMap x map
+  \param yMap y map
+  \param from index of the first point to be painted
+  \param to index of the last point to be painted
+
+  \sa Density, setColorMap(), draw(), drawCurve(), drawDots()
+*/
+void QwtPlotCurve::drawDensity(QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    int from, int to) const
+{
+    QRect rect = d_data->canvasRect;
+    if ( !rect.isValid() )
+    {
+        rect = QRect(
+            QPoint(qRound(qwtMin(xMap.p1(), xMap.p2())),
+                qRound(qwtMin(yMap.p1(), yMap.p2()))),
+            QPoint(qRound(qwtMax(xMap.p1(), xMap.p2())),
+                qRound(qwtMax(yMap.p1(), yMap.p2()))));
     }
+
+    if ( rect.isEmpty() )
+        return;
+
+    QwtReplotStatistics::addPointsTransformed(to - from + 1);
+
+    const QImage image = qwtDensityImage(xMap, yMap, *d_xy,
+        from, to - from + 1, rect, *d_data->colorMap,
+        d_data->paintAttributes & PaintMultiThreaded);
+
+    painter->drawImage(rect.topLeft(), image);
 }
 
 /*!
@@ -916,17 +2079,39 @@ void QwtPlotCurve::drawSteps(QPainter *painter,
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     int from, int to) const
 {
-    QwtPolygonF polyline(2 * (to - from) + 1);
+    const QwtData *data = d_xy;
+
+    QwtPolygonFData reducedData = QwtPolygonF();
+    if ( d_data->paintAttributes & PaintLevelOfDetail )
+    {
+        reducedData = QwtPolygonFData(
+            d_data->levelOfDetail(*d_xy, xMap, yMap, from, to));
+
+        data = &reducedData;
+        from = 0;
+        to = int(reducedData.size()) - 1;
+    }
+
+    if ( to < from )
+        return;
+
+    QwtPolygonF points;
+    qwtBuildPolyline(xMap, yMap, *data, from, to - from + 1,
+        d_data->paintAttributes & PaintDecimated,
+        d_data->curveType == Yfx,
+        d_data->paintAttributes & PaintMultiThreaded, points);
+
+    QwtPolygonF polyline(2 * points.size() - 1);
 
     bool inverted = d_data->curveType == Yfx;
     if ( d_data->attributes & Inverted )
         inverted = !inverted;
 
     int i,ip;
-    for (i = from, ip = 0; i <= to; i++, ip += 2)
+    for (i = 0, ip = 0; i < int(points.size()); i++, ip += 2)
     {
-        const double xi = xMap.xTransform(x(i));
-        const double yi = yMap.xTransform(y(i));
+        const double xi = points[i].x();
+        const double yi = points[i].y();
 
         if ( ip > 0 )
         {
@@ -939,13 +2124,27 @@ void QwtPlotCurve::drawSteps(QPainter *painter,
         polyline[ip] = QPointF(xi, yi);
     }
 
-	if ( d_data->canvasRect.isValid() && (d_data->paintAttributes & ClipPolygons) )
-		polyline = QwtClipper::clipPolygonF(d_data->canvasRect, polyline);
+    const bool doClip = d_data->canvasRect.isValid() &&
+        (d_data->paintAttributes & ClipPolygons);
 
-    QwtPainter::drawPolyline(painter, polyline);
+    if ( doClip )
+    {
+        d_data->drawClipped(painter, polyline);
+    }
+    else
+    {
+        QwtReplotStatistics::addPointsPainted(polyline.size());
+        QwtPainter::drawPolyline(painter, polyline);
+    }
 
     if ( d_data->brush.style() != Qt::NoBrush )
+    {
+        // the filled area needs to be closed along the borders
+        if ( doClip )
+            polyline = QwtClipper::clipPolygonF(d_data->canvasRect, polyline);
+
         fillCurve(painter, xMap, yMap, polyline);
+    }
 }
 
 
@@ -962,6 +2161,8 @@ void QwtPlotCurve::setCurveAttribute(CurveAttribute attribute, bool on)
     if ( bool(d_data->attributes & attribute) == on )
         return;
 
+    waitForRender();
+
     if ( on )
         d_data->attributes |= attribute;
     else
@@ -989,7 +2190,10 @@ void QwtPlotCurve::setCurveType(CurveType curveType)
 {
     if ( d_data->curveType != curveType )
     {
+        waitForRender();
+
         d_data->curveType = curveType;
+        invalidateCache();
         itemChanged();
     }
 }
@@ -1011,9 +2215,13 @@ QwtPlotCurve::CurveType QwtPlotCurve::curveType() const
 */
 void QwtPlotCurve::setCurveFitter(QwtCurveFitter *curveFitter)
 {
+    waitForRender();
+
     delete d_data->curveFitter;
     d_data->curveFitter = curveFitter;
 
+    d_data->fittedCurve = PrivateData::FittedCurve();
+
     itemChanged();
 }
 
@@ -1026,6 +2234,35 @@ QwtCurveFitter *QwtPlotCurve::curveFitter() const
     return d_data->curveFitter;
 }
 
+/*!
+  \brief Change the color map
+
+  The color map is used to map the number of points per pixel
+  into colors for the Density style. The default is a
+  QwtLinearColorMap from Qt::blue to Qt::yellow.
+
+  \param colorMap Color map
+  \sa colorMap(), Density
+*/
+void QwtPlotCurve::setColorMap(const QwtColorMap &colorMap)
+{
+    waitForRender();
+
+    delete d_data->colorMap;
+    d_data->colorMap = colorMap.copy();
+
+    itemChanged();
+}
+
+/*!
+   \return Color map used for the Density style
+   \sa setColorMap()
+*/
+const QwtColorMap &QwtPlotCurve::colorMap() const
+{
+    return *d_data->colorMap;
+}
+
 /*!
   Fill the area between the curve and the baseline with
   the curve brush
@@ -1057,6 +2294,7 @@ void QwtPlotCurve::fillCurve(QPainter *painter,
     painter->setPen(QPen(Qt::NoPen));
     painter->setBrush(b);
 
+    QwtReplotStatistics::addPointsPainted(pa.size());
     QwtPainter::drawPolygon(painter, pa);
 
     painter->restore();
@@ -1107,42 +2345,32 @@ void QwtPlotCurve::drawSymbols(QPainter *painter, const QwtSymbol &symbol,
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     int from, int to) const
 {
-    painter->setBrush(symbol.brush());
-    painter->setPen(QwtPainter::scaledPen(symbol.pen()));
+    const int size = to - from + 1;
 
-    const QwtMetricsMap &metricsMap = QwtPainter::metricsMap();
+    QwtPolygonF points;
+    qwtBuildPolyline(xMap, yMap, *d_xy, from, size, 0,
+        d_data->curveType == Yfx,
+        d_data->paintAttributes & PaintMultiThreaded, points);
 
-    QRect rect;
-    rect.setSize(metricsMap.screenToLayout(symbol.size()));
+    int numPoints = size;
 
 	if ( (to > from) && (d_data->paintAttributes & PaintFiltered) &&
 		 d_data->canvasRect.isValid() )
     {
 		PrivateData::PixelMatrix pixelMatrix(d_data->canvasRect);
 
-        for (int i = from; i <= to; i++)
+        numPoints = 0;
+        for (int i = 0; i < size; i++)
         {
-            const QPoint pi( xMap.transform(x(i)),
-                yMap.transform(y(i)) );
+            const QPoint pi( qRound(points[i].x()), qRound(points[i].y()) );
 
             if ( pixelMatrix.testPixel(pi) )
-            {
-                rect.moveCenter(pi);
-                symbol.draw(painter, rect);
-            }
+                points[numPoints++] = points[i];
         }
     }
-    else
-    {
-        for (int i = from; i <= to; i++)
-        {
-            const int xi = xMap.transform(x(i));
-            const int yi = yMap.transform(y(i));
 
-            rect.moveCenter(QPoint(xi, yi));
-            symbol.draw(painter, rect);
-        }
-    }
+    QwtReplotStatistics::addPointsPainted(numPoints);
+    symbol.drawSymbols(painter, points.data(), numPoints);
 }
 
 /*!
@@ -1162,6 +2390,8 @@ void QwtPlotCurve::setBaseline(double reference)
 {
     if ( d_data->reference != reference )
     {
+        waitForRender();
+
         d_data->reference = reference;
         itemChanged();
     }
@@ -1188,13 +2418,16 @@ int QwtPlotCurve::dataSize() const
 /*!
   Find the closest curve point for a specific position
 
+  When the spatial index is enabled, the point is looked up in
+  O(log(n)) on average. Otherwise all points are iterated.
+
   \param pos Position, where to look for the closest curve point
   \param dist If dist != nullptr, closestPoint() returns the distance between
               the position and the clostest curve point
   \return Index of the closest curve point, or -1 if none can be found
           ( f.e when the curve has no points )
-  \note closestPoint() implements a dumb algorithm, that iterates
-        over all points
+
+  \sa setSpatialIndexEnabled(), invalidateCache()
 */
 int QwtPlotCurve::closestPoint(const QPoint &pos, double *dist) const
 {
@@ -1204,25 +2437,105 @@ int QwtPlotCurve::closestPoint(const QPoint &pos, double *dist) const
     const QwtScaleMap xMap = plot()->canvasMap(xAxis());
     const QwtScaleMap yMap = plot()->canvasMap(yAxis());
 
-    int index = -1;
-    double dmin = 1.0e10;
+    const QwtSpatialIndex *index = spatialIndex();
+    if ( index )
+        return index->closestPoint(xMap, yMap, QwtDoublePoint(pos), dist);
 
-    for (int i=0; i < dataSize(); i++)
-    {
-        const double cx = xMap.xTransform(x(i)) - pos.x();
-        const double cy = yMap.xTransform(y(i)) - pos.y();
+    return QwtSpatialIndex::closestPoint(*d_xy,
+        xMap, yMap, QwtDoublePoint(pos), dist);
+}
 
-        const double f = qwtSqr(cx) + qwtSqr(cy);
-        if (f < dmin)
-        {
-            index = i;
-            dmin = f;
-        }
-    }
-    if ( dist )
-        *dist = sqrt(dmin);
+/*!
+  \brief Find the points inside of a rectangle
+
+  \param rect Rectangle in scale coordinates, including its borders
+  \return Ascending indices of the points inside of rect
+
+  \sa closestPoint(), QwtPlot::curvePointsInside(), QwtSpatialIndex
+*/
+QwtArray<int> QwtPlotCurve::pointsInside(const QwtDoubleRect &rect) const
+{
+    if ( dataSize() <= 0 )
+        return QwtArray<int>();
+
+    const QwtSpatialIndex *index = spatialIndex();
+    if ( index )
+        return index->pointsInside(rect);
+
+    return QwtSpatialIndex::pointsInside(*d_xy, rect);
+}
+
+/*!
+  \brief Find the points inside of a polygon
+
+  \param polygon Polygon in scale coordinates, using the odd-even rule.
+         The points selected by a QwtPlotPicker are an example.
+  \return Ascending indices of the points inside of polygon
+
+  \sa closestPoint(), QwtPlot::curvePointsInside(), QwtSpatialIndex
+*/
+QwtArray<int> QwtPlotCurve::pointsInside(const QwtPolygonF &polygon) const
+{
+    if ( dataSize() <= 0 )
+        return QwtArray<int>();
+
+    const QwtSpatialIndex *index = spatialIndex();
+    if ( index )
+        return index->pointsInside(polygon);
+
+    return QwtSpatialIndex::pointsInside(*d_xy, polygon);
+}
+
+/*!
+  \brief Find the points inside of a rectangle
+
+  \param rect Rectangle in canvas coordinates, including its borders
+  \return Ascending indices of the points inside of rect
+
+  \sa closestPoint(), QwtPlot::curvePointsInside(), QwtSpatialIndex
+*/
+QwtArray<int> QwtPlotCurve::pointsInside(const QRect &rect) const
+{
+    if ( plot() == nullptr || dataSize() <= 0 || rect.isEmpty() )
+        return QwtArray<int>();
+
+    // the pixels of the right/bottom border are included
+    const QwtDoubleRect canvasRect(rect.x(), rect.y(),
+        rect.width() - 1, rect.height() - 1);
+
+    const QwtScaleMap xMap = plot()->canvasMap(xAxis());
+    const QwtScaleMap yMap = plot()->canvasMap(yAxis());
+
+    const QwtSpatialIndex *index = spatialIndex();
+    if ( index )
+        return index->pointsInside(xMap, yMap, canvasRect);
+
+    return QwtSpatialIndex::pointsInside(*d_xy, xMap, yMap, canvasRect);
+}
+
+/*!
+  \brief Find the points inside of a polygon
+
+  \param polygon Polygon in canvas coordinates, using the odd-even rule.
+         The points selected by a QwtPicker are an example.
+  \return Ascending indices of the points inside of polygon
+
+  \sa closestPoint(), QwtPlot::curvePointsInside(), QwtSpatialIndex
+*/
+QwtArray<int> QwtPlotCurve::pointsInside(const QwtPolygon &polygon) const
+{
+    if ( plot() == nullptr || dataSize() <= 0 )
+        return QwtArray<int>();
+
+    const QwtScaleMap xMap = plot()->canvasMap(xAxis());
+    const QwtScaleMap yMap = plot()->canvasMap(yAxis());
+
+    const QwtSpatialIndex *index = spatialIndex();
+    if ( index )
+        return index->pointsInside(xMap, yMap, QwtPolygonF(polygon));
 
-    return index;
+    return QwtSpatialIndex::pointsInside(*d_xy,
+        xMap, yMap, QwtPolygonF(polygon));
 }
 
 //!  Update the widget that represents the curve on the legend
@@ -22,6 +22,8 @@ class QPainter;
 class QwtScaleMap;
 class QwtSymbol;
 class QwtCurveFitter;
+class QwtColorMap;
+class QwtSpatialIndex;
 
 /*!
   \brief A plot item, that represents a series of points
@@ -96,6 +98,14 @@ public:
            Draw dots at the locations of the data points. Note:
            This is different from a dotted line (see setPen()), and faster
            as a curve in NoStyle style and a symbol painting a point.
+         - Density\n
+           Count the points, that are mapped to each pixel, and
+           paint the counts as an image, using the color map
+           ( see setColorMap() ). The counts are mapped logarithmically,
+           so that the image shows where points are overplotted.
+           The effort is proportional to the number of points without
+           any QPainter call per point. With PaintMultiThreaded the
+           points are counted concurrently.
          - UserCurve\n
            Styles >= UserCurve are reserved for derived
            classes of QwtPlotCurve that overload drawCurve() with
@@ -111,6 +121,7 @@ public:
         Sticks,
         Steps,
         Dots,
+        Density,
 
         UserCurve = 100
     };
@@ -123,8 +134,8 @@ public:
         interpolate/smooth the curve, before it is painted.
         Note that curve fitting requires temorary memory
         for calculating coefficients and additional points.
-        If painting in Fitted mode is slow it might be better
-        to fit the points, before they are passed to QwtPlotCurve.
+        With the CacheFitted paint attribute the fitted curve
+        is cached.
       - Inverted\n
         For Steps only. Draws a step function
         from the right to the left.
@@ -150,6 +161,51 @@ public:
           are far outside the visible area (f.e when zooming deep) this
           might be a substantial improvement for the painting performance
           ( especially on Windows ).
+        - PaintLevelOfDetail ( Lines and Steps style only )\n
+          Paint only the first, minimum, maximum and last point of
+          consecutive points, that are mapped to the same pixel column
+          ( row for Xfy ). The points are looked up in a QwtDataPyramid,
+          that is built, when the curve is painted the first time.
+          Then the painting effort is proportional to the width of the
+          canvas, instead of the number of points. The pyramid is updated
+          incrementally, when points have been appended, or when points
+          have been dropped from the beginning of streaming data
+          ( see QwtData::appendCount() ). In all other situations, where
+          the data has been modified without setData(), invalidateCache()
+          has to be called.
+          Not available in combination with the Fitted curve attribute.
+        - PaintVisibleRange\n
+          When the points are ordered in x direction ( y for Xfy )
+          the first and the last point inside the visible interval
+          of the map are found by a binary search. Only these points
+          ( plus one point on each side ) are painted, what makes
+          painting a zoomed view of a long curve much faster.
+          The order is detected from the data, when it is not
+          assigned by setDataOrder().
+        - PaintDecimated ( Lines and Steps style only )\n
+          Consecutive points, that are mapped to the same pixel column
+          ( row for Xfy ) are reduced to the first, the minimum, the
+          maximum and the last point of the column, while the polyline
+          is built. The result has at most 4 points per pixel column, but
+          paints the same pixels as all points. Contrary to
+          PaintLevelOfDetail all points have to be mapped, but nothing
+          is cached.
+        - CacheFitted ( Fitted curves only )\n
+          The fitted curve is cached and only recalculated, when the
+          size of the data, the settings of the fitter or the scale maps
+          have been changed. When the fitter is affine invariant for the
+          points ( see QwtCurveFitter::isAffineInvariant() ) and the
+          scales are linear, the points are fitted in scale coordinates,
+          so that the result can be reused, when the scales are changed.
+          When the data has been modified without setData(),
+          like the memory of setRawData(), invalidateCache() has to
+          be called.
+        - PaintMultiThreaded\n
+          Large curves are split into chunks of points, that are mapped,
+          filtered and decimated concurrently on the global thread pool
+          ( see QwtParallel ). Only painting the result happens in the
+          calling thread. The data object has to support concurrent
+          reads, what is the case for all data classes of Qwt.
 
         The default is, that no paint attributes are enabled.
 
@@ -158,7 +214,37 @@ public:
     enum PaintAttribute
     {
         PaintFiltered = 1,
-        ClipPolygons = 2
+        ClipPolygons = 2,
+        PaintLevelOfDetail = 4,
+        PaintVisibleRange = 8,
+        PaintDecimated = 16,
+        PaintMultiThreaded = 32,
+        CacheFitted = 64
+    };
+
+    /*!
+        Order of the points in x direction ( y direction for Xfy )
+
+        - DetectOrder\n
+          The order is detected by iterating over the points,
+          when it is needed the first time. The result is cached.
+        - AscendingOrder\n
+          The points are in ascending order.
+        - DescendingOrder\n
+          The points are in descending order.
+        - NoOrder\n
+          The points are not ordered.
+
+        The default is DetectOrder.
+
+        \sa setDataOrder(), PaintVisibleRange
+    */
+    enum DataOrder
+    {
+        DetectOrder,
+        AscendingOrder,
+        DescendingOrder,
+        NoOrder
     };
 
     explicit QwtPlotCurve();
@@ -175,6 +261,15 @@ public:
     void setPaintAttribute(PaintAttribute, bool on = true);
     bool testPaintAttribute(PaintAttribute) const;
 
+    void setDataOrder(DataOrder);
+    DataOrder dataOrder() const;
+
+    void setSpatialIndexEnabled(bool on);
+    bool spatialIndexEnabled() const;
+    const QwtSpatialIndex *spatialIndex() const;
+
+    void invalidateCache();
+
     void setRawData(const double *x, const double *y, int size);
     void setData(const double *xData, const double *yData, int size);
     void setData(const QwtArray<double> &xData, const QwtArray<double> &yData);
@@ -183,6 +278,12 @@ public:
 
     int closestPoint(const QPoint &pos, double *dist = nullptr) const;
 
+    QwtArray<int> pointsInside(const QwtDoubleRect &) const;
+    QwtArray<int> pointsInside(const QwtPolygonF &) const;
+
+    QwtArray<int> pointsInside(const QRect &) const;
+    QwtArray<int> pointsInside(const QwtPolygon &) const;
+
     QwtData &data();
     const QwtData &data() const;
 
@@ -191,6 +292,8 @@ public:
     inline double y(int i) const;
 
     virtual QwtDoubleRect boundingRect() const;
+    virtual QRect damageRect(const QwtScaleMap &, const QwtScaleMap &,
+        const QwtDoubleRect &) const;
 
     //! boundingRect().left()
     inline double minXValue() const { return boundingRect().left(); }
@@ -222,6 +325,9 @@ public:
     void setCurveFitter(QwtCurveFitter *);
     QwtCurveFitter *curveFitter() const;
 
+    void setColorMap(const QwtColorMap &);
+    const QwtColorMap &colorMap() const;
+
     virtual void draw(QPainter *p,
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QRect &) const;
@@ -231,6 +337,7 @@ public:
         int from, int to) const;
 
     void draw(int from, int to) const;
+    bool drawAppended() const;
 
     virtual void updateLegend(QwtLegend *) const;
 
@@ -258,6 +365,9 @@ protected:
     void drawSteps(QPainter *p,
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         int from, int to) const;
+    void drawDensity(QPainter *p,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        int from, int to) const;
 
     void fillCurve(QPainter *,
         const QwtScaleMap &, const QwtScaleMap &,
@@ -272,9 +382,16 @@ private:
     PrivateData *d_data;
 };
 
-//! \return the the curve data
+/*!
+  \return the the curve data
+
+  As the data might be modified through the returned reference,
+  like by appending to a QwtRingBufferData, a running asynchronous
+  render is completed before.
+*/
 inline QwtData &QwtPlotCurve::data()
 {
+    waitForRender();
     return *d_xy;
 }
 
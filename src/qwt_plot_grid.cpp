@@ -49,6 +49,9 @@ QwtPlotGrid::QwtPlotGrid():
 //! Destructor
 QwtPlotGrid::~QwtPlotGrid()
 {
+    // the item might be painted by an asynchronous render
+    detach();
+
     delete d_data;
 }
 
@@ -69,6 +72,8 @@ void QwtPlotGrid::enableX(bool tf)
 {
     if ( d_data->xEnabled != tf )
     {
+        waitForRender();
+
         d_data->xEnabled = tf;
         itemChanged();
     }
@@ -83,6 +88,8 @@ void QwtPlotGrid::enableY(bool tf)
 {
     if ( d_data->yEnabled != tf )
     {
+        waitForRender();
+
         d_data->yEnabled = tf;  
         itemChanged();
     }
@@ -97,6 +104,8 @@ void QwtPlotGrid::enableXMin(bool tf)
 {
     if ( d_data->xMinEnabled != tf )
     {
+        waitForRender();
+
         d_data->xMinEnabled = tf;
         itemChanged();
     }
@@ -111,6 +120,8 @@ void QwtPlotGrid::enableYMin(bool tf)
 {
     if ( d_data->yMinEnabled != tf )
     {
+        waitForRender();
+
         d_data->yMinEnabled = tf;
         itemChanged();
     }
@@ -125,6 +136,8 @@ void QwtPlotGrid::setXDiv(const QwtScaleDiv &scaleDiv)
 {
     if ( d_data->xScaleDiv != scaleDiv )
     {
+        waitForRender();
+
         d_data->xScaleDiv = scaleDiv;
         itemChanged();
     }
@@ -139,6 +152,8 @@ void QwtPlotGrid::setYDiv(const QwtScaleDiv &scaleDiv)
 {
     if ( d_data->yScaleDiv != scaleDiv )
     {
+        waitForRender();
+
         d_data->yScaleDiv = scaleDiv;    
         itemChanged();
     }
@@ -157,6 +172,8 @@ void QwtPlotGrid::setPen(const QPen &pen)
 {
     if ( d_data->majPen != pen || d_data->minPen != pen )
     {
+        waitForRender();
+
         d_data->majPen = pen;
         d_data->minPen = pen;
         itemChanged();
@@ -176,6 +193,8 @@ void QwtPlotGrid::setMajPen(const QPen &pen)
 {
     if ( d_data->majPen != pen )
     {
+        waitForRender();
+
         d_data->majPen = pen;
         itemChanged();
     }
@@ -194,6 +213,8 @@ void QwtPlotGrid::setMinPen(const QPen &pen)
 {
     if ( d_data->minPen != pen )
     {
+        waitForRender();
+
         d_data->minPen = pen;  
         itemChanged();
     }
@@ -259,9 +280,17 @@ void QwtPlotGrid::drawLines(QPainter *painter, const QRect &canvasRect,
     const int y1 = canvasRect.top();
     const int y2 = canvasRect.bottom();
 
-    for (uint i = 0; i < (uint)values.count(); i++)
+    const int count = values.count();
+
+    QwtArray<double> mapped(count);
+    for (int i = 0; i < count; i++)
+        mapped[i] = values[i];
+
+    scaleMap.xTransform(mapped.constData(), mapped.data(), count);
+
+    for (int i = 0; i < count; i++)
     {
-        const int value = scaleMap.transform(values[i]);
+        const int value = qRound(mapped[i]);
         if ( orientation == Qt::Horizontal )
         {
             if ((value >= y1) && (value <= y2))
@@ -7,12 +7,23 @@
  * modify it under the terms of the Qwt License, Version 1.0
  *****************************************************************************/
 
+#include "qwt_math.h"
 #include "qwt_text.h"
 #include "qwt_plot.h"
+#include "qwt_plot_canvas.h"
 #include "qwt_legend.h"
 #include "qwt_legend_item.h"
+#include "qwt_scale_map.h"
 #include "qwt_plot_item.h"
 
+static inline bool qwtSameMap(const QwtScaleMap &map1,
+    const QwtScaleMap &map2)
+{
+    return map1.s1() == map2.s1() && map1.s2() == map2.s2() &&
+        map1.p1() == map2.p1() && map1.p2() == map2.p2() &&
+        map1.transformation()->type() == map2.transformation()->type();
+}
+
 class QwtPlotItem::PrivateData
 {
 public:
@@ -23,8 +34,67 @@ public:
         renderHints(0),
         z(0.0),
         xAxis(QwtPlot::xBottom),
-        yAxis(QwtPlot::yLeft)
+        yAxis(QwtPlot::yLeft),
+        damageState(NotPainted)
+    {
+    }
+
+    /*
+      Report the area of the canvas, where the item has been painted
+      before, and where it will be painted now. Only, when the canvas
+      tracks damaged regions the new area is calculated. Otherwise the
+      area of the item remains unknown, until it is changed again with
+      enabled tracking.
+
+      When the item is detached, the area of the previous change is
+      reported without calling any virtual method of the item, as it
+      might be called from the destructor.
+     */
+    void addDamage(const QwtPlotItem *item, bool attached)
     {
+        if ( damageState == UnknownArea )
+        {
+            plot->addDamagedRect(QRect());
+        }
+        else if ( damageState == KnownArea )
+        {
+            // a change of the scales repaints the complete canvas,
+            // so the area of the item has been moved since
+
+            if ( qwtSameMap(plot->canvasMap(damageXAxis), damageXMap) &&
+                qwtSameMap(plot->canvasMap(damageYAxis), damageYMap) )
+            {
+                plot->addDamagedRect(damageRect);
+            }
+            else
+            {
+                plot->addDamagedRect(QRect());
+            }
+        }
+
+        damageState = NotPainted;
+
+        if ( !attached )
+            return;
+
+        const QwtPlotCanvas *canvas = plot->canvas();
+        if ( !canvas->testPaintAttribute(QwtPlotCanvas::PaintDamaged) ||
+            canvas->testPaintAttribute(QwtPlotCanvas::PaintAsynchronous) )
+        {
+            damageState = UnknownArea;
+            return;
+        }
+
+        damageXAxis = xAxis;
+        damageYAxis = yAxis;
+        damageXMap = plot->canvasMap(xAxis);
+        damageYMap = plot->canvasMap(yAxis);
+
+        damageRect = item->damageRect(damageXMap, damageYMap,
+            item->boundingRect());
+        damageState = KnownArea;
+
+        plot->addDamagedRect(damageRect);
     }
 
     mutable QwtPlot *plot;
@@ -38,6 +108,21 @@ public:
     int yAxis;
 
     QwtText title;
+
+    // the area of the item on the canvas since the last change
+    enum DamageState
+    {
+        NotPainted,
+        KnownArea,
+        UnknownArea
+    };
+
+    DamageState damageState;
+    QRect damageRect;
+    int damageXAxis;
+    int damageYAxis;
+    QwtScaleMap damageXMap;
+    QwtScaleMap damageYMap;
 };
 
 /*! 
@@ -50,7 +135,14 @@ QwtPlotItem::QwtPlotItem(const QwtText &title)
     d_data->title = title;
 }
 
-//! Destroy the QwtPlotItem
+/*!
+  \brief Destroy the QwtPlotItem
+
+  The item is detached from its plot, what cancels an asynchronous
+  render ( see QwtPlotCanvas::PaintAsynchronous ). As this happens after
+  the destructors of derived classes, those have to call detach()
+  before releasing anything, that is needed by draw().
+*/
 QwtPlotItem::~QwtPlotItem()
 {
     attach(nullptr);
@@ -84,7 +176,15 @@ void QwtPlotItem::attach(QwtPlot *plot)
                 delete legendItem; 
         }
 
+        // the item might be deleted, while being painted asynchronously
+        if ( d_data->plot->canvas()->isRendering() )
+            d_data->plot->canvas()->cancelRender();
+
         d_data->plot->attachItem(this, false);
+        d_data->plot->canvas()->invalidateLayer(d_data->z);
+
+        if ( !testItemAttribute(Overlay) )
+            d_data->addDamage(this, false);
 
         if ( d_data->plot->autoReplot() )
             d_data->plot->update();
@@ -146,6 +246,11 @@ void QwtPlotItem::setZ(double z)
 { 
     if ( d_data->z != z )
     {
+        waitForRender();
+
+        if ( d_data->plot )
+            d_data->plot->canvas()->invalidateLayer(d_data->z);
+
         d_data->z = z; 
         if ( d_data->plot )
         {
@@ -178,6 +283,8 @@ void QwtPlotItem::setTitle(const QwtText &title)
 {
     if ( d_data->title != title )
     {
+        waitForRender();
+
         d_data->title = title; 
         itemChanged();
     }
@@ -204,11 +311,22 @@ void QwtPlotItem::setItemAttribute(ItemAttribute attribute, bool on)
 {
     if ( bool(d_data->attributes & attribute) != on )
     {
+        waitForRender();
+
         if ( on )
             d_data->attributes |= attribute;
         else
             d_data->attributes &= ~attribute;
 
+        if ( attribute == Overlay && d_data->plot )
+        {
+            // the item moves from the cached canvas to the overlay
+            // or vice versa
+            d_data->plot->addDamagedRect(QRect());
+            d_data->plot->canvas()->invalidateLayer(d_data->z);
+            d_data->plot->autoRefresh();
+        }
+
         itemChanged();
     }
 }
@@ -237,6 +355,8 @@ void QwtPlotItem::setRenderHint(RenderHint hint, bool on)
 {
     if ( ((d_data->renderHints & hint) != 0) != on )
     {
+        waitForRender();
+
         if ( on )
             d_data->renderHints |= hint;
         else
@@ -280,6 +400,8 @@ void QwtPlotItem::setVisible(bool on)
 { 
     if ( on != d_data->isVisible )
     {
+        waitForRender();
+
         d_data->isVisible = on; 
         itemChanged(); 
     }
@@ -295,22 +417,68 @@ bool QwtPlotItem::isVisible() const
 }
 
 /*! 
-   Update the legend and call QwtPlot::autoRefresh for the 
-   parent plot.
+   Invalidate the layer of the item on the canvas, update the legend
+   and call QwtPlot::autoRefresh for the parent plot.
 
-   \sa updateLegend()
+   The cached contents of the canvas are not affected by Overlay items,
+   that are not included in the autoscaling. For those the canvas is
+   only repainted, when autoReplot is enabled.
+
+   \sa updateLegend(), QwtPlotCanvas::invalidateLayer(),
+       QwtPlotCanvas::updateOverlay()
 */
 void QwtPlotItem::itemChanged()
 {
     if ( d_data->plot )
     {
+        const bool isOverlay = testItemAttribute(Overlay)
+            && !testItemAttribute(AutoScale);
+
+        if ( !testItemAttribute(Overlay) )
+            d_data->addDamage(this, true);
+
+        if ( !isOverlay )
+            d_data->plot->canvas()->invalidateLayer(d_data->z);
+
         if ( d_data->plot->legend() )
             updateLegend(d_data->plot->legend());
 
-        d_data->plot->autoRefresh();
+        if ( isOverlay )
+        {
+            if ( d_data->plot->autoReplot() )
+                d_data->plot->canvas()->updateOverlay();
+        }
+        else
+        {
+            d_data->plot->autoRefresh();
+        }
     }
 }
 
+/*!
+   \brief Block until a running asynchronous render has been completed
+
+   With QwtPlotCanvas::PaintAsynchronous the attached items are painted
+   from a worker thread. So every method, that modifies an attribute
+   or an object, that is read by draw(), has to call waitForRender()
+   before the modification - not only before itemChanged() - to keep
+   the worker from reading an object, that is modified or deleted
+   at the same time.
+
+   \sa QwtPlotCanvas::waitForRender(), QwtPlotCanvas::isRendering()
+*/
+void QwtPlotItem::waitForRender() const
+{
+    if ( d_data->plot == nullptr )
+        return;
+
+    // a slot connected to QwtPlotCanvas::renderFinished()
+    // might have started the next render
+    QwtPlotCanvas *canvas = d_data->plot->canvas();
+    while ( canvas->isRendering() )
+        canvas->waitForRender();
+}
+
 /*!  
    Set X and Y axis
 
@@ -323,6 +491,8 @@ void QwtPlotItem::itemChanged()
 */
 void QwtPlotItem::setAxis(int xAxis, int yAxis)
 {
+    waitForRender();
+
     if (xAxis == QwtPlot::xBottom || xAxis == QwtPlot::xTop )
        d_data->xAxis = xAxis;
 
@@ -344,6 +514,8 @@ void QwtPlotItem::setXAxis(int axis)
 {
     if (axis == QwtPlot::xBottom || axis == QwtPlot::xTop )
     {
+       waitForRender();
+
        d_data->xAxis = axis;
        itemChanged();    
     }
@@ -361,6 +533,8 @@ void QwtPlotItem::setYAxis(int axis)
 {
     if (axis == QwtPlot::yLeft || axis == QwtPlot::yRight )
     {
+       waitForRender();
+
        d_data->yAxis = axis;
        itemChanged();   
     }
@@ -533,6 +707,58 @@ QRect QwtPlotItem::transform(const QwtScaleMap &xMap,
     return QRect(x1, y1, x2 - x1 + 1, y2 - y1 + 1);
 }
 
+/*!
+   \brief Area of the canvas, that is affected by painting the item
+
+   When the item has been changed, the areas of the old and the new
+   bounding rectangle are repainted, if the canvas tracks damaged
+   regions ( see QwtPlotCanvas::PaintDamaged ). Otherwise damageRect()
+   is not called.
+
+   The default implementation maps rect and adds a margin of
+   2 pixels for the pen. Items painting outside of their bounding
+   rectangle need to reimplement damageRect().
+
+   \param xMap X map
+   \param yMap Y map
+   \param rect Bounding rectangle in scale coordinates
+
+   \return Rectangle in paint coordinates, or an invalid rectangle,
+           when the area is unknown. Then the complete canvas
+           needs to be repainted.
+
+   \sa QwtPlot::addDamagedRect(), boundingRect()
+*/
+QRect QwtPlotItem::damageRect(const QwtScaleMap &xMap,
+    const QwtScaleMap &yMap, const QwtDoubleRect &rect) const
+{
+    // also true for NaNs
+    if ( !( rect.width() >= 0.0 && rect.height() >= 0.0 ) )
+        return QRect();
+
+    const int margin = 2;
+
+    double x1 = xMap.xTransform(rect.left());
+    double x2 = xMap.xTransform(rect.right());
+    double y1 = yMap.xTransform(rect.top());
+    double y2 = yMap.xTransform(rect.bottom());
+
+    if ( !( qAbs(x1) < 1e9 && qAbs(x2) < 1e9 &&
+        qAbs(y1) < 1e9 && qAbs(y2) < 1e9 ) )
+    {
+        return QRect();
+    }
+
+    if ( x2 < x1 )
+        qSwap(x1, x2);
+    if ( y2 < y1 )
+        qSwap(y1, y2);
+
+    return QRect(QPoint(int(::floor(x1)), int(::floor(y1))),
+        QPoint(int(::ceil(x2)), int(::ceil(y2)))).adjusted(
+        -margin, -margin, margin, margin);
+}
+
 /*!
    Transform a rectangle from paint to scale coordinates
 
@@ -94,13 +94,20 @@ public:
        - AutoScale \n
          The boundingRect() of the item is included in the 
          autoscaling calculation.
+       - Overlay \n
+         The item is painted on top of the cached contents of the
+         canvas, whenever the canvas is repainted. A change of the
+         item repaints the canvas from its cache, instead of
+         replotting. This is intended for items, that move
+         frequently like cursors or markers for a current value.
 
        \sa setItemAttribute(), testItemAttribute()
      */
     enum ItemAttribute
     {
         Legend = 1,
-        AutoScale = 2
+        AutoScale = 2,
+        Overlay = 4
     };
 
     //! Render hints
@@ -180,8 +187,15 @@ public:
     
     QRect transform(const QwtScaleMap &, const QwtScaleMap &, 
         const QwtDoubleRect&) const; 
+
     QwtDoubleRect invTransform(const QwtScaleMap &, const QwtScaleMap &,
-        const QRect&) const; 
+        const QRect&) const;
+
+    virtual QRect damageRect(const QwtScaleMap &, const QwtScaleMap &,
+        const QwtDoubleRect &) const;
+
+protected:
+    void waitForRender() const;
 
 private:
     // Disabled copy constructor and operator=
@@ -60,6 +60,9 @@ QwtPlotMarker::QwtPlotMarker():
 //! Destructor
 QwtPlotMarker::~QwtPlotMarker()
 {
+    // the item might be painted by an asynchronous render
+    detach();
+
     delete d_data;
 }
 
@@ -98,6 +101,8 @@ void QwtPlotMarker::setValue(double x, double y)
 {
     if ( x != d_data->xValue || y != d_data->yValue )
     {
+        waitForRender();
+
         d_data->xValue = x; 
         d_data->yValue = y; 
         itemChanged(); 
@@ -311,6 +316,8 @@ void QwtPlotMarker::setLineStyle(QwtPlotMarker::LineStyle st)
 {
     if ( st != d_data->style )
     {
+        waitForRender();
+
         d_data->style = st;
         itemChanged();
     }
@@ -332,6 +339,8 @@ QwtPlotMarker::LineStyle QwtPlotMarker::lineStyle() const
 */
 void QwtPlotMarker::setSymbol(const QwtSymbol &s)
 {
+    waitForRender();
+
     delete d_data->symbol;
     d_data->symbol = s.clone();
     itemChanged();
@@ -355,6 +364,8 @@ void QwtPlotMarker::setLabel(const QwtText& label)
 {
     if ( label != d_data->label )
     {
+        waitForRender();
+
         d_data->label = label;
         itemChanged();
     }
@@ -389,6 +400,8 @@ void QwtPlotMarker::setLabelAlignment(Qt::Alignment align)
 {
     if ( align != d_data->labelAlignment )
     {
+        waitForRender();
+
         d_data->labelAlignment = align;
         itemChanged();
     }
@@ -417,6 +430,8 @@ void QwtPlotMarker::setLabelOrientation(Qt::Orientation orientation)
 {
     if ( orientation != d_data->labelOrientation )
     {
+        waitForRender();
+
         d_data->labelOrientation = orientation;
         itemChanged();
     }
@@ -448,6 +463,8 @@ void QwtPlotMarker::setSpacing(int spacing)
     if ( spacing == d_data->spacing )
         return;
 
+    waitForRender();
+
     d_data->spacing = spacing;
     itemChanged();
 }
@@ -474,6 +491,8 @@ void QwtPlotMarker::setLinePen(const QPen &pen)
 {
     if ( pen != d_data->pen )
     {
+        waitForRender();
+
         d_data->pen = pen;
         itemChanged();
     }
@@ -492,3 +511,70 @@ QwtDoubleRect QwtPlotMarker::boundingRect() const
 {
     return QwtDoubleRect(d_data->xValue, d_data->yValue, 0.0, 0.0);
 }
+
+/*!
+  \brief Area of the canvas, that is affected by painting the marker
+
+  Lines are extended over the complete canvas. As the size of the
+  label depends on the font of the painter, the area of a marker
+  with a label is unknown.
+
+  \param xMap X map
+  \param yMap Y map
+  \param rect Bounding rectangle in scale coordinates
+
+  \return Rectangle in paint coordinates, or an invalid rectangle,
+          when the area is unknown.
+  \sa QwtPlotItem::damageRect(), boundingRect()
+*/
+QRect QwtPlotMarker::damageRect(const QwtScaleMap &xMap,
+    const QwtScaleMap &yMap, const QwtDoubleRect &rect) const
+{
+    if ( !d_data->label.isEmpty() )
+        return QRect();
+
+    const double x = xMap.xTransform(rect.left());
+    const double y = yMap.xTransform(rect.top());
+
+    // also true for NaNs
+    if ( !( qAbs(x) < 1e9 && qAbs(y) < 1e9 ) )
+        return QRect();
+
+    const QPoint pos(xMap.transform(rect.left()),
+        yMap.transform(rect.top()));
+
+    QRect damage(pos, pos);
+
+    if ( d_data->symbol->style() != QwtSymbol::NoSymbol )
+    {
+        const int pw = qwtMax(d_data->symbol->pen().width(), 1);
+        const QSize size = d_data->symbol->size() + QSize(pw, pw);
+
+        QRect symbolRect(0, 0, size.width(), size.height());
+        symbolRect.moveCenter(pos);
+
+        damage |= symbolRect;
+    }
+
+    if ( d_data->style != NoLine )
+    {
+        // the damaged region is clipped to the canvas
+        const int extent = 1 << 24;
+
+        const int pw = qwtMax(d_data->pen.width(), 1);
+
+        if ( d_data->style == HLine || d_data->style == Cross )
+        {
+            damage |= QRect(QPoint(-extent, pos.y() - pw),
+                QPoint(extent, pos.y() + pw));
+        }
+        if ( d_data->style == VLine || d_data->style == Cross )
+        {
+            damage |= QRect(QPoint(pos.x() - pw, -extent),
+                QPoint(pos.x() + pw, extent));
+        }
+    }
+
+    const int margin = 2;
+    return damage.adjusted(-margin, -margin, margin, margin);
+}
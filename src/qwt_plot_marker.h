@@ -99,6 +99,9 @@ public:
     
     virtual QwtDoubleRect boundingRect() const;
 
+    virtual QRect damageRect(const QwtScaleMap &, const QwtScaleMap &,
+        const QwtDoubleRect &) const;
+
 protected:
     void drawAt(QPainter *,const QRect &, const QPoint &) const;
 
@@ -12,6 +12,7 @@
 #include <qpainter.h>
 #include <qpaintengine.h>
 #include "qwt_painter.h"
+#include "qwt_painter_context.h"
 #include "qwt_legend_item.h"
 #include "qwt_plot.h"
 #include "qwt_plot_canvas.h"
@@ -70,6 +71,9 @@ void QwtPlot::print(QPainter *painter, const QRect &plotRect,
             !plotRect.isValid() || size().isNull() )
        return;
 
+    // items must not be painted by an asynchronous render concurrently
+    ((QwtPlotCanvas *)canvas())->waitForRender();
+
     painter->save();
 #if 1
     /*
@@ -83,7 +87,11 @@ void QwtPlot::print(QPainter *painter, const QRect &plotRect,
 #endif
 
     // All paint operations need to be scaled according to
-    // the paint device metrics. 
+    // the paint device metrics. The metrics map is set for
+    // a context of our own, so that other threads are not affected.
+
+    QwtPainterContext context(*QwtPainter::context());
+    QwtPainterContext *previousContext = QwtPainter::setContext(&context);
 
     QwtPainter::setMetricsMap(this, painter->device());
     const QwtMetricsMap &metricsMap = QwtPainter::metricsMap();
@@ -218,7 +226,7 @@ void QwtPlot::print(QPainter *painter, const QRect &plotRect,
     // The canvas maps are already scaled. 
     QwtPainter::setMetricsMap(painter->device(), painter->device());
     printCanvas(painter, boundingRect, canvasRect, map, pfilter);
-    QwtPainter::resetMetricsMap();
+    QwtPainter::setContext(previousContext);
 
     ((QwtPlot *)this)->plotLayout()->invalidate();
 
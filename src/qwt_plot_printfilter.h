@@ -39,6 +39,7 @@ public:
         PrintGrid = 8,
         PrintBackground = 16,
         PrintFrameWithScales = 32,
+        PrintOverlay = 64,
 
         PrintAll = ~PrintFrameWithScales
     }; 
@@ -103,6 +103,9 @@ QwtPlotRasterItem::QwtPlotRasterItem(const QwtText& title):
 //! Destructor
 QwtPlotRasterItem::~QwtPlotRasterItem()
 {
+    // the item might be painted by an asynchronous render
+    detach();
+
     delete d_data;
 }
 
@@ -149,6 +152,8 @@ void QwtPlotRasterItem::setAlpha(int alpha)
 
     if ( alpha != d_data->alpha )
     {
+        waitForRender();
+
         d_data->alpha = alpha;
 
         itemChanged();
@@ -177,6 +182,8 @@ void QwtPlotRasterItem::setCachePolicy(
 {
     if ( d_data->cache.policy != policy )
     {
+        waitForRender();
+
         d_data->cache.policy = policy;
 
         invalidateCache();
@@ -199,6 +206,8 @@ QwtPlotRasterItem::CachePolicy QwtPlotRasterItem::cachePolicy() const
 */
 void QwtPlotRasterItem::invalidateCache()
 {
+    waitForRender();
+
     d_data->cache.image = QImage();
     d_data->cache.rect = QwtDoubleRect();
     d_data->cache.size = QSize();
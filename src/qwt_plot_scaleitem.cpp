@@ -65,6 +65,9 @@ QwtPlotScaleItem::QwtPlotScaleItem(
 //! Destructor
 QwtPlotScaleItem::~QwtPlotScaleItem()
 {
+    // the item might be painted by an asynchronous render
+    detach();
+
     delete d_data;
 }
 
@@ -85,6 +88,8 @@ int QwtPlotScaleItem::rtti() const
 */
 void QwtPlotScaleItem::setScaleDiv(const QwtScaleDiv& scaleDiv)
 {
+    waitForRender();
+
     d_data->scaleDivFromAxis = false;
     d_data->scaleDraw->setScaleDiv(scaleDiv);
 }
@@ -106,6 +111,8 @@ void QwtPlotScaleItem::setScaleDivFromAxis(bool on)
 {
     if ( on != d_data->scaleDivFromAxis )
     {
+        waitForRender();
+
         d_data->scaleDivFromAxis = on;
         if ( on )
         {
@@ -138,6 +145,8 @@ void QwtPlotScaleItem::setPalette(const QPalette &palette)
 {
     if ( palette != d_data->palette )
     {
+        waitForRender();
+
         d_data->palette = palette;
         itemChanged();
     }
@@ -160,6 +169,8 @@ void QwtPlotScaleItem::setFont(const QFont &font)
 {
     if ( font != d_data->font )
     {
+        waitForRender();
+
         d_data->font = font;
         itemChanged();
     }
@@ -190,6 +201,8 @@ void QwtPlotScaleItem::setScaleDraw(QwtScaleDraw *scaleDraw)
     if ( scaleDraw == nullptr )
         return;
 
+    waitForRender();
+
     if ( scaleDraw != d_data->scaleDraw )
         delete d_data->scaleDraw;
 
@@ -216,10 +229,13 @@ const QwtScaleDraw *QwtPlotScaleItem::scaleDraw() const
 
 /*!
    \return Scale draw
+   \note A running asynchronous render is completed before,
+         as the scale draw might be modified.
    \sa setScaleDraw()
 */
 QwtScaleDraw *QwtPlotScaleItem::scaleDraw() 
 {
+    waitForRender();
     return d_data->scaleDraw;
 }
 
@@ -238,6 +254,8 @@ void QwtPlotScaleItem::setPosition(double pos)
 {
     if ( d_data->position != pos )
     {
+        waitForRender();
+
         d_data->position = pos;
         d_data->borderDistance = -1;
         itemChanged();
@@ -276,6 +294,8 @@ void QwtPlotScaleItem::setBorderDistance(int distance)
 
     if ( distance != d_data->borderDistance )
     {
+        waitForRender();
+
         d_data->borderDistance = distance;
         itemChanged();
     }
@@ -311,6 +331,8 @@ void QwtPlotScaleItem::setAlignment(QwtScaleDraw::Alignment alignment)
     QwtScaleDraw *sd = d_data->scaleDraw;
     if ( sd->alignment() != alignment )
     {
+        waitForRender();
+
         sd->setAlignment(alignment);
         itemChanged();
     }
@@ -110,6 +110,9 @@ QwtPlotSpectrogram::QwtPlotSpectrogram(const QString &title):
 //! Destructor
 QwtPlotSpectrogram::~QwtPlotSpectrogram()
 {
+    // the item might be painted by an asynchronous render
+    detach();
+
     delete d_data;
 }
 
@@ -133,6 +136,8 @@ void QwtPlotSpectrogram::setDisplayMode(DisplayMode mode, bool on)
 {
     if ( on != bool(mode & d_data->displayMode) )
     {
+        waitForRender();
+
         if ( on )
             d_data->displayMode |= mode;
         else
@@ -166,6 +171,8 @@ bool QwtPlotSpectrogram::testDisplayMode(DisplayMode mode) const
 */
 void QwtPlotSpectrogram::setColorMap(const QwtColorMap &colorMap)
 {
+    waitForRender();
+
     delete d_data->colorMap;
     d_data->colorMap = colorMap.copy();
 
@@ -196,6 +203,8 @@ void QwtPlotSpectrogram::setDefaultContourPen(const QPen &pen)
 {
     if ( pen != d_data->defaultContourPen )
     {
+        waitForRender();
+
         d_data->defaultContourPen = pen;
         itemChanged();
     }
@@ -245,6 +254,8 @@ void QwtPlotSpectrogram::setConrecAttribute(
     if ( bool(d_data->conrecAttributes & attribute) == on )
         return;
 
+    waitForRender();
+
     if ( on )
         d_data->conrecAttributes |= attribute;
     else
@@ -280,6 +291,8 @@ bool QwtPlotSpectrogram::testConrecAttribute(
 */
 void QwtPlotSpectrogram::setContourLevels(const QwtValueList &levels)
 {
+    waitForRender();
+
     d_data->contourLevels = levels;
 #if QT_VERSION < 0x050f00
     qSort(d_data->contourLevels);
@@ -310,6 +323,8 @@ QwtValueList QwtPlotSpectrogram::contourLevels() const
 */
 void QwtPlotSpectrogram::setData(const QwtRasterData &data)
 {
+    waitForRender();
+
     delete d_data->data;
     d_data->data = data.copy();
 
@@ -423,6 +438,18 @@ QImage QwtPlotSpectrogram::renderImage(
 
     d_data->data->initRaster(area, rect.size());
 
+    // the x coordinates are the same for all lines
+
+    const int width = rect.width();
+
+    QwtArray<double> tx(width);
+    for ( int x = 0; x < width; x++ )
+        tx[x] = rect.left() + x;
+
+    xxMap.invTransform(tx.constData(), tx.data(), width);
+
+    const double *xValues = tx.constData();
+
     if ( d_data->colorMap->format() == QwtColorMap::RGB )
     {
         for ( int y = rect.top(); y <= rect.bottom(); y++ )
@@ -430,12 +457,10 @@ QImage QwtPlotSpectrogram::renderImage(
             const double ty = yyMap.invTransform(y);
 
             QRgb *line = (QRgb *)image.scanLine(y - rect.top());
-            for ( int x = rect.left(); x <= rect.right(); x++ )
+            for ( int x = 0; x < width; x++ )
             {
-                const double tx = xxMap.invTransform(x);
-
                 *line++ = d_data->colorMap->rgb(intensityRange,
-                    d_data->data->value(tx, ty));
+                    d_data->data->value(xValues[x], ty));
             }
         }
     }
@@ -448,12 +473,10 @@ QImage QwtPlotSpectrogram::renderImage(
             const double ty = yyMap.invTransform(y);
 
             unsigned char *line = image.scanLine(y - rect.top());
-            for ( int x = rect.left(); x <= rect.right(); x++ )
+            for ( int x = 0; x < width; x++ )
             {
-                const double tx = xxMap.invTransform(x);
-
                 *line++ = d_data->colorMap->colorIndex(intensityRange,
-                    d_data->data->value(tx, ty));
+                    d_data->data->value(xValues[x], ty));
             }
         }
     }
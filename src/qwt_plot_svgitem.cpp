@@ -62,6 +62,9 @@ QwtPlotSvgItem::QwtPlotSvgItem(const QwtText& title):
 //! Destructor
 QwtPlotSvgItem::~QwtPlotSvgItem()
 {
+    // the item might be painted by an asynchronous render
+    detach();
+
     delete d_data;
 }
 
@@ -92,6 +95,8 @@ int QwtPlotSvgItem::rtti() const
 bool QwtPlotSvgItem::loadFile(const QwtDoubleRect &rect, 
     const QString &fileName)
 {
+    waitForRender();
+
     d_data->boundingRect = rect;
     const bool ok = d_data->renderer.load(fileName);
     itemChanged();
@@ -109,6 +114,8 @@ bool QwtPlotSvgItem::loadFile(const QwtDoubleRect &rect,
 bool QwtPlotSvgItem::loadData(const QwtDoubleRect &rect, 
     const QByteArray &data)
 {
+    waitForRender();
+
     d_data->boundingRect = rect;
     const bool ok = d_data->renderer.load(data);
     itemChanged();
@@ -127,9 +134,14 @@ const QSvgRenderer &QwtPlotSvgItem::renderer() const
     return d_data->renderer;
 }
 
-//! \return Renderer used to render the SVG data
+/*!
+   \return Renderer used to render the SVG data
+   \note A running asynchronous render is completed before,
+         as the renderer might be modified.
+*/
 QSvgRenderer &QwtPlotSvgItem::renderer()
 {
+    waitForRender();
     return d_data->renderer;
 }
 
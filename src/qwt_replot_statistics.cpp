@@ -0,0 +1,164 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_plot_item.h"
+#include "qwt_replot_statistics.h"
+
+// statistics of the item, that is painted in the calling thread
+static thread_local QwtReplotStatistics::ItemStatistics *qwtCurrentItem
+    = nullptr;
+
+/*!
+  Constructor
+  \param item Painted item
+*/
+QwtReplotStatistics::ItemStatistics::ItemStatistics(
+        const QwtPlotItem *item):
+    item(item),
+    rtti(item ? item->rtti() : QwtPlotItem::Rtti_PlotItem),
+    drawTime(0),
+    pointsTransformed(0),
+    pointsPainted(0)
+{
+}
+
+//! Constructor
+QwtReplotStatistics::QwtReplotStatistics()
+{
+    reset();
+}
+
+//! Clear all timings and item statistics
+void QwtReplotStatistics::reset()
+{
+    for ( int i = 0; i < StageCount; i++ )
+        d_stageTimes[i] = 0;
+
+    d_totalTime = 0;
+    d_items.clear();
+}
+
+/*!
+  Set the time of a stage
+  \sa addStageTime(), stageTime()
+*/
+void QwtReplotStatistics::setStageTime(Stage stage, qint64 nsecs)
+{
+    if ( stage >= 0 && stage < StageCount )
+        d_stageTimes[stage] = nsecs;
+}
+
+/*!
+  Add time to a stage, that might be passed several times
+  \sa setStageTime(), stageTime()
+*/
+void QwtReplotStatistics::addStageTime(Stage stage, qint64 nsecs)
+{
+    if ( stage >= 0 && stage < StageCount )
+        d_stageTimes[stage] += nsecs;
+}
+
+/*!
+  \return Time of a stage
+  \sa setStageTime()
+*/
+qint64 QwtReplotStatistics::stageTime(Stage stage) const
+{
+    if ( stage >= 0 && stage < StageCount )
+        return d_stageTimes[stage];
+
+    return 0;
+}
+
+/*!
+  Set the time of the complete replot
+  \sa totalTime()
+*/
+void QwtReplotStatistics::setTotalTime(qint64 nsecs)
+{
+    d_totalTime = nsecs;
+}
+
+/*!
+  \return Time of the complete replot
+  \sa setTotalTime()
+*/
+qint64 QwtReplotStatistics::totalTime() const
+{
+    return d_totalTime;
+}
+
+/*!
+  Append the statistics of a painted item
+  \sa items()
+*/
+void QwtReplotStatistics::addItem(const ItemStatistics &statistics)
+{
+    d_items += statistics;
+}
+
+/*!
+  \return Statistics of the painted items in the order of
+          completion. An item might be listed more than once,
+          f.e. when it is painted to the cache and as overlay.
+  \sa addItem()
+*/
+const QwtArray<QwtReplotStatistics::ItemStatistics> &
+QwtReplotStatistics::items() const
+{
+    return d_items;
+}
+
+/*!
+  \brief Set the statistics, that are updated by the counters
+         of the calling thread
+
+  \param statistics Statistics of the item, that is painted now,
+                    or nullptr to stop counting
+  \return Previous statistics
+  \sa addPointsTransformed(), addPointsPainted()
+*/
+QwtReplotStatistics::ItemStatistics *QwtReplotStatistics::setCurrentItem(
+    ItemStatistics *statistics)
+{
+    ItemStatistics *previous = qwtCurrentItem;
+    qwtCurrentItem = statistics;
+
+    return previous;
+}
+
+/*!
+  \return Statistics of the item, that is painted in the calling
+          thread, or nullptr, when no statistics are recorded
+  \sa setCurrentItem()
+*/
+QwtReplotStatistics::ItemStatistics *QwtReplotStatistics::currentItem()
+{
+    return qwtCurrentItem;
+}
+
+/*!
+  Count points, that have been mapped into paint device coordinates
+  \sa addPointsPainted(), currentItem()
+*/
+void QwtReplotStatistics::addPointsTransformed(qint64 numPoints)
+{
+    if ( qwtCurrentItem )
+        qwtCurrentItem->pointsTransformed += numPoints;
+}
+
+/*!
+  Count points, that have been passed to QPainter
+  \sa addPointsTransformed(), currentItem()
+*/
+void QwtReplotStatistics::addPointsPainted(qint64 numPoints)
+{
+    if ( qwtCurrentItem )
+        qwtCurrentItem->pointsPainted += numPoints;
+}
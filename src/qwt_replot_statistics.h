@@ -0,0 +1,115 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_REPLOT_STATISTICS_H
+#define QWT_REPLOT_STATISTICS_H 1
+
+#include "qwt_global.h"
+#include "qwt_array.h"
+
+class QwtPlotItem;
+
+/*!
+  \brief Timings and counters of a replot
+
+  When statistics are enabled for a plot ( see
+  QwtPlot::setStatisticsEnabled() ), QwtPlot::replot() measures the
+  time of each stage and QwtPlot::drawItem() records the time
+  for painting each item, that is painted during the replot.
+
+  Items count the points, that have been mapped into paint device
+  coordinates, and the points, that have been passed to QPainter
+  after filtering and clipping, by addPointsTransformed() and
+  addPointsPainted(). These calls are cheap, when no
+  statistics are recorded.
+
+  All times are in nanoseconds.
+
+  \sa QwtPlot::replotStatistics(), QwtPlot::statisticsUpdated()
+*/
+class QWT_EXPORT QwtReplotStatistics
+{
+public:
+    /*!
+      \brief Stages of a replot
+
+      - UpdateAxes\n
+        QwtPlot::updateAxes()
+      - PostedEvents\n
+        Processing of the posted layout requests, including
+        the activation of the layout
+      - LayoutActivate\n
+        QwtPlotLayout::activate()
+      - Canvas\n
+        Repaint of the canvas, including painting the items
+
+      \sa stageTime()
+     */
+    enum Stage
+    {
+        UpdateAxes,
+        PostedEvents,
+        LayoutActivate,
+        Canvas,
+
+        StageCount
+    };
+
+    //! Statistics of painting an item
+    class QWT_EXPORT ItemStatistics
+    {
+    public:
+        explicit ItemStatistics(const QwtPlotItem *item = nullptr);
+
+        /*!
+          Painted item. The item might have been deleted after
+          the replot.
+         */
+        const QwtPlotItem *item;
+
+        //! Runtime type information of the item
+        int rtti;
+
+        //! Time for painting the item
+        qint64 drawTime;
+
+        //! Number of points, that have been mapped
+        qint64 pointsTransformed;
+
+        //! Number of points, that have been passed to QPainter
+        qint64 pointsPainted;
+    };
+
+    QwtReplotStatistics();
+
+    void reset();
+
+    void setStageTime(Stage, qint64 nsecs);
+    void addStageTime(Stage, qint64 nsecs);
+    qint64 stageTime(Stage) const;
+
+    void setTotalTime(qint64 nsecs);
+    qint64 totalTime() const;
+
+    void addItem(const ItemStatistics &);
+    const QwtArray<ItemStatistics> &items() const;
+
+    static ItemStatistics *setCurrentItem(ItemStatistics *);
+    static ItemStatistics *currentItem();
+
+    static void addPointsTransformed(qint64 numPoints);
+    static void addPointsPainted(qint64 numPoints);
+
+private:
+    qint64 d_stageTimes[StageCount];
+    qint64 d_totalTime;
+    QwtArray<ItemStatistics> d_items;
+};
+
+#endif
@@ -9,6 +9,12 @@
 
 #include "qwt_scale_map.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#define QWT_SCALE_MAP_SSE2 1
+#include <emmintrin.h>
+#endif
+
 double QwtScaleMap::LogMin = 1.0e-150;
 double QwtScaleMap::LogMax = 1.0e150;
 
@@ -78,6 +84,49 @@ double QwtScaleTransformation::invXForm(double p, double p1, double p2,
         return s1 + (s2 - s1) / (p2 - p1) * (p - p1);
 }
 
+/*
+  out = origin + (in - offset) * factor
+
+  The operations are the same as in the inlined code of
+  QwtScaleMap::xTransform(), so that the results are identical.
+ */
+static void qwtAffineTransform(const double *in, double *out, size_t size,
+    size_t inStride, size_t outStride,
+    double offset, double factor, double origin)
+{
+    size_t i = 0;
+
+#if QWT_SCALE_MAP_SSE2
+    const __m128d o = _mm_set1_pd(offset);
+    const __m128d f = _mm_set1_pd(factor);
+    const __m128d p = _mm_set1_pd(origin);
+
+    if ( inStride == 1 && outStride == 1 )
+    {
+        for ( ; i + 2 <= size; i += 2 )
+        {
+            const __m128d v = _mm_loadu_pd(in + i);
+            _mm_storeu_pd(out + i,
+                _mm_add_pd(p, _mm_mul_pd(_mm_sub_pd(v, o), f)));
+        }
+    }
+    else
+    {
+        for ( ; i + 2 <= size; i += 2 )
+        {
+            __m128d v = _mm_set_pd(in[(i + 1) * inStride], in[i * inStride]);
+            v = _mm_add_pd(p, _mm_mul_pd(_mm_sub_pd(v, o), f));
+
+            _mm_storel_pd(out + i * outStride, v);
+            _mm_storeh_pd(out + (i + 1) * outStride, v);
+        }
+    }
+#endif
+
+    for ( ; i < size; i++ )
+        out[i * outStride] = origin + (in[i * inStride] - offset) * factor;
+}
+
 /*!
   \brief Constructor
 
@@ -226,3 +275,99 @@ void QwtScaleMap::newFactor()
         default:;
     }
 }
+
+/*!
+  Transform an array of values related to the scale interval into
+  values related to the interval of the paint device
+
+  The result is the same as calling xTransform() for each value, but
+  the type of the transformation is checked only once and linear
+  transformations are done with SSE2 instructions, when available.
+  For logarithmic scales the evaluation of log() dominates. Other
+  transformations fall back to QwtScaleTransformation::xForm().
+
+  \param values Values relative to the coordinates of the scale
+  \param out Array for the transformed values. It might be values.
+  \param size Number of values
+  \param stride Distance between two values in values,
+                f.e. 2 for the x coordinates of an array of points
+  \param outStride Distance between two values in out
+
+  \sa invTransform()
+*/
+void QwtScaleMap::xTransform(const double *values, double *out,
+    size_t size, size_t stride, size_t outStride) const
+{
+    switch( d_transformation->type() )
+    {
+        case QwtScaleTransformation::Linear:
+        {
+            qwtAffineTransform(values, out, size, stride, outStride,
+                d_s1, d_cnv, d_p1);
+            break;
+        }
+        case QwtScaleTransformation::Log10:
+        {
+            for ( size_t i = 0; i < size; i++ )
+            {
+                out[i * outStride] =
+                    d_p1 + log(values[i * stride] / d_s1) * d_cnv;
+            }
+            break;
+        }
+        default:
+        {
+            for ( size_t i = 0; i < size; i++ )
+            {
+                out[i * outStride] = d_transformation->xForm(
+                    values[i * stride], d_s1, d_s2, d_p1, d_p2);
+            }
+        }
+    }
+}
+
+/*!
+  Transform an array of values related to the paint device
+  into values related to the interval of the scale
+
+  The result is the same as calling invTransform() for each value.
+
+  \param values Values relative to the coordinates of the paint device
+  \param out Array for the transformed values. It might be values.
+  \param size Number of values
+  \param stride Distance between two values in values
+  \param outStride Distance between two values in out
+
+  \sa xTransform()
+*/
+void QwtScaleMap::invTransform(const double *values, double *out,
+    size_t size, size_t stride, size_t outStride) const
+{
+    switch( d_transformation->type() )
+    {
+        case QwtScaleTransformation::Linear:
+        {
+            qwtAffineTransform(values, out, size, stride, outStride,
+                d_p1, (d_s2 - d_s1) / (d_p2 - d_p1), d_s1);
+            break;
+        }
+        case QwtScaleTransformation::Log10:
+        {
+            const double f = log(d_s2 / d_s1);
+            for ( size_t i = 0; i < size; i++ )
+            {
+                out[i * outStride] = exp((values[i * stride] - d_p1)
+                    / (d_p2 - d_p1) * f) * d_s1;
+            }
+            break;
+        }
+        default:
+        {
+            for ( size_t i = 0; i < size; i++ )
+            {
+                out[i * outStride] = d_transformation->invXForm(
+                    values[i * stride], d_p1, d_p2, d_s1, d_s2);
+            }
+        }
+    }
+}
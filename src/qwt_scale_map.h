@@ -75,6 +75,11 @@ public:
 
     double xTransform(double x) const;
 
+    void xTransform(const double *values, double *out, size_t size,
+        size_t stride = 1, size_t outStride = 1) const;
+    void invTransform(const double *values, double *out, size_t size,
+        size_t stride = 1, size_t outStride = 1) const;
+
     inline double p1() const;
     inline double p2() const;
 
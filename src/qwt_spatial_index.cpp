@@ -0,0 +1,689 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include <algorithm>
+#include "qwt_math.h"
+#include "qwt_array.h"
+#include "qwt_data.h"
+#include "qwt_scale_map.h"
+#include "qwt_parallel.h"
+#include "qwt_spatial_index.h"
+
+// maximum number of points of a leaf, that are searched sequentially
+static const int qwtLeafSize = 8;
+
+// number of points, that are read from the data at once
+static const int qwtScanBlockSize = 4096;
+
+// minimum number of points, that justifies an additional thread
+static const int qwtMinChunkSize = 65536;
+
+class QwtSpatialIndex::PrivateData
+{
+public:
+    class Point
+    {
+    public:
+        inline double value(int axis) const
+        {
+            return axis == 0 ? x : y;
+        }
+
+        static inline bool lessX(const Point &p1, const Point &p2)
+        {
+            return p1.x < p2.x;
+        }
+
+        static inline bool lessY(const Point &p1, const Point &p2)
+        {
+            return p1.y < p2.y;
+        }
+
+        double x;
+        double y;
+        int index;
+    };
+
+    class Range
+    {
+    public:
+        int from;
+        int to;
+        int axis;
+    };
+
+    class Query
+    {
+    public:
+        const QwtScaleMap *maps[2];
+        bool increasing[2];
+        double pos[2];
+
+        double dist;
+        int index;
+    };
+
+    /*
+      A rectangle and an optional polygon in the coordinate system
+      of the maps. Without maps the region is in data coordinates.
+     */
+    class Region
+    {
+    public:
+        inline double coordinate(int axis, double value) const
+        {
+            return maps[axis] ? maps[axis]->xTransform(value) : value;
+        }
+
+        const QwtScaleMap *maps[2];
+        bool increasing[2];
+
+        double min[2];
+        double max[2];
+
+        const QwtPolygonF *polygon;
+    };
+
+    int split(const Range &range);
+    void build(const Range &range);
+
+    static void initQuery(Query &query, const QwtScaleMap &xMap,
+        const QwtScaleMap &yMap, const QwtDoublePoint &pos);
+    static bool initRegion(Region &region, const QwtScaleMap *xMap,
+        const QwtScaleMap *yMap, const QwtDoubleRect &,
+        const QwtPolygonF *);
+
+    void closestPoint(const Range &range, Query &query) const;
+    static void testPoint(const Point &point, Query &query);
+
+    void pointsInside(const Range &range, const Region &region,
+        QwtArray<int> &indices) const;
+    static void testPoint(const Point &point, const Region &region,
+        QwtArray<int> &indices);
+
+    QwtArray<int> pointsInside(const QwtScaleMap *xMap,
+        const QwtScaleMap *yMap, const QwtDoubleRect &,
+        const QwtPolygonF *) const;
+
+    static void scan(const QwtData &data, Query &query);
+    static QwtArray<int> scan(const QwtData &data,
+        const QwtScaleMap *xMap, const QwtScaleMap *yMap,
+        const QwtDoubleRect &, const QwtPolygonF *);
+
+    QwtArray<Point> points;
+};
+
+/*
+  The median of the range is moved to its center. The points in
+  front of it are not behind it and vice versa. Returns the position
+  of the median.
+ */
+int QwtSpatialIndex::PrivateData::split(const Range &range)
+{
+    Point *p = points.data();
+    const int mid = range.from + ( range.to - range.from ) / 2;
+
+    std::nth_element(p + range.from, p + mid, p + range.to,
+        range.axis == 0 ? Point::lessX : Point::lessY);
+
+    return mid;
+}
+
+void QwtSpatialIndex::PrivateData::build(const Range &range)
+{
+    if ( range.to - range.from <= qwtLeafSize )
+        return;
+
+    const int mid = split(range);
+
+    const Range r1 = { range.from, mid, 1 - range.axis };
+    const Range r2 = { mid + 1, range.to, 1 - range.axis };
+
+    build(r1);
+    build(r2);
+}
+
+void QwtSpatialIndex::PrivateData::initQuery(Query &query,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtDoublePoint &pos)
+{
+    query.maps[0] = &xMap;
+    query.maps[1] = &yMap;
+
+    query.increasing[0] =
+        ( xMap.p2() - xMap.p1() ) * ( xMap.s2() - xMap.s1() ) >= 0.0;
+    query.increasing[1] =
+        ( yMap.p2() - yMap.p1() ) * ( yMap.s2() - yMap.s1() ) >= 0.0;
+
+    query.pos[0] = pos.x();
+    query.pos[1] = pos.y();
+
+    query.dist = 1.0e10;
+    query.index = -1;
+}
+
+bool QwtSpatialIndex::PrivateData::initRegion(Region &region,
+    const QwtScaleMap *xMap, const QwtScaleMap *yMap,
+    const QwtDoubleRect &rect, const QwtPolygonF *polygon)
+{
+    // rectangles of a single row or column of pixels have a zero size
+    const QwtDoubleRect r = rect.normalized();
+    if ( !( r.width() >= 0.0 && r.height() >= 0.0 ) )
+        return false;
+
+    region.maps[0] = xMap;
+    region.maps[1] = yMap;
+
+    for ( int axis = 0; axis < 2; axis++ )
+    {
+        const QwtScaleMap *map = region.maps[axis];
+
+        region.increasing[axis] = ( map == nullptr ) ||
+            ( map->p2() - map->p1() ) * ( map->s2() - map->s1() ) >= 0.0;
+    }
+
+    region.min[0] = r.left();
+    region.max[0] = r.right();
+    region.min[1] = r.top();
+    region.max[1] = r.bottom();
+
+    region.polygon = polygon;
+
+    return true;
+}
+
+inline void QwtSpatialIndex::PrivateData::testPoint(
+    const Point &point, Query &query)
+{
+    const double dx = query.maps[0]->xTransform(point.x) - query.pos[0];
+    const double dy = query.maps[1]->xTransform(point.y) - query.pos[1];
+
+    const double dist = qwtSqr(dx) + qwtSqr(dy);
+
+    // in case of equal distances the first point wins
+    if ( dist < query.dist ||
+        ( dist == query.dist && point.index < query.index ) )
+    {
+        query.dist = dist;
+        query.index = point.index;
+    }
+}
+
+void QwtSpatialIndex::PrivateData::closestPoint(
+    const Range &range, Query &query) const
+{
+    const Point *p = points.data();
+
+    if ( range.to - range.from <= qwtLeafSize )
+    {
+        for ( int i = range.from; i < range.to; i++ )
+            testPoint(p[i], query);
+
+        return;
+    }
+
+    const int axis = range.axis;
+    const int mid = range.from + ( range.to - range.from ) / 2;
+
+    testPoint(p[mid], query);
+
+    /*
+      The transformations are monotonic. So the distance to the
+      position of the median in paint device coordinates is a lower
+      bound for the distance to all points on the other side.
+     */
+    const double d = query.pos[axis] -
+        query.maps[axis]->xTransform(p[mid].value(axis));
+
+    const Range lower = { range.from, mid, 1 - axis };
+    const Range upper = { mid + 1, range.to, 1 - axis };
+
+    const bool lowerFirst = query.increasing[axis] ? d <= 0.0 : d >= 0.0;
+
+    closestPoint(lowerFirst ? lower : upper, query);
+    if ( qwtSqr(d) <= query.dist )
+        closestPoint(lowerFirst ? upper : lower, query);
+}
+
+inline void QwtSpatialIndex::PrivateData::testPoint(
+    const Point &point, const Region &region, QwtArray<int> &indices)
+{
+    const double x = region.coordinate(0, point.x);
+    if ( x < region.min[0] || x > region.max[0] )
+        return;
+
+    const double y = region.coordinate(1, point.y);
+    if ( y < region.min[1] || y > region.max[1] )
+        return;
+
+    if ( region.polygon &&
+        !region.polygon->containsPoint(QPointF(x, y), Qt::OddEvenFill) )
+    {
+        return;
+    }
+
+    indices += point.index;
+}
+
+void QwtSpatialIndex::PrivateData::pointsInside(const Range &range,
+    const Region &region, QwtArray<int> &indices) const
+{
+    const Point *p = points.data();
+
+    if ( range.to - range.from <= qwtLeafSize )
+    {
+        for ( int i = range.from; i < range.to; i++ )
+            testPoint(p[i], region, indices);
+
+        return;
+    }
+
+    const int axis = range.axis;
+    const int mid = range.from + ( range.to - range.from ) / 2;
+
+    testPoint(p[mid], region, indices);
+
+    const double c = region.coordinate(axis, p[mid].value(axis));
+
+    bool visitLower, visitUpper;
+    if ( region.increasing[axis] )
+    {
+        visitLower = region.min[axis] <= c;
+        visitUpper = region.max[axis] >= c;
+    }
+    else
+    {
+        visitLower = region.max[axis] >= c;
+        visitUpper = region.min[axis] <= c;
+    }
+
+    if ( visitLower )
+    {
+        const Range lower = { range.from, mid, 1 - axis };
+        pointsInside(lower, region, indices);
+    }
+
+    if ( visitUpper )
+    {
+        const Range upper = { mid + 1, range.to, 1 - axis };
+        pointsInside(upper, region, indices);
+    }
+}
+
+QwtArray<int> QwtSpatialIndex::PrivateData::pointsInside(
+    const QwtScaleMap *xMap, const QwtScaleMap *yMap,
+    const QwtDoubleRect &rect, const QwtPolygonF *polygon) const
+{
+    QwtArray<int> indices;
+
+    Region region;
+    if ( points.isEmpty() ||
+        !initRegion(region, xMap, yMap, rect, polygon) )
+    {
+        return indices;
+    }
+
+    const Range root = { 0, int(points.size()), 0 };
+    pointsInside(root, region, indices);
+
+    std::sort(indices.begin(), indices.end());
+
+    return indices;
+}
+
+/*
+  Queries without an index iterate over all points
+  in blocks of a limited size.
+ */
+void QwtSpatialIndex::PrivateData::scan(const QwtData &data, Query &query)
+{
+    const int size = int(data.size());
+
+    for ( int i0 = 0; i0 < size; i0 += qwtScanBlockSize )
+    {
+        const int n = qwtMin(size - i0, qwtScanBlockSize);
+        const QwtDataBlock block(data, i0, n);
+
+        for ( int i = 0; i < n; i++ )
+        {
+            const Point point = { block.x(i), block.y(i), i0 + i };
+
+            if ( point.x == point.x && point.y == point.y ) // no NaN
+                testPoint(point, query);
+        }
+    }
+}
+
+QwtArray<int> QwtSpatialIndex::PrivateData::scan(const QwtData &data,
+    const QwtScaleMap *xMap, const QwtScaleMap *yMap,
+    const QwtDoubleRect &rect, const QwtPolygonF *polygon)
+{
+    QwtArray<int> indices;
+
+    Region region;
+    if ( !initRegion(region, xMap, yMap, rect, polygon) )
+        return indices;
+
+    const int size = int(data.size());
+
+    for ( int i0 = 0; i0 < size; i0 += qwtScanBlockSize )
+    {
+        const int n = qwtMin(size - i0, qwtScanBlockSize);
+        const QwtDataBlock block(data, i0, n);
+
+        for ( int i = 0; i < n; i++ )
+        {
+            const Point point = { block.x(i), block.y(i), i0 + i };
+
+            if ( point.x == point.x && point.y == point.y ) // no NaN
+                testPoint(point, region, indices);
+        }
+    }
+
+    return indices;
+}
+
+//! Constructor, initializing an empty index
+QwtSpatialIndex::QwtSpatialIndex()
+{
+    d_data = new PrivateData;
+}
+
+//! Destructor
+QwtSpatialIndex::~QwtSpatialIndex()
+{
+    delete d_data;
+}
+
+/*!
+  \brief Build the index for the points of a series
+
+  Points with NaN coordinates are ignored. The upper levels of the
+  tree are split sequentially, the subtrees are built concurrently
+  on the thread pool.
+
+  \param data Series of points
+*/
+void QwtSpatialIndex::setData(const QwtData &data)
+{
+    const int size = int(data.size());
+
+    d_data->points.resize(size);
+    PrivateData::Point *p = d_data->points.data();
+
+    int count = 0;
+
+    for ( int i0 = 0; i0 < size; i0 += qwtScanBlockSize )
+    {
+        const int n = qwtMin(size - i0, qwtScanBlockSize);
+        const QwtDataBlock block(data, i0, n);
+
+        for ( int i = 0; i < n; i++ )
+        {
+            const double x = block.x(i);
+            const double y = block.y(i);
+
+            if ( x == x && y == y ) // no NaN
+            {
+                p[count].x = x;
+                p[count].y = y;
+                p[count].index = i0 + i;
+                count++;
+            }
+        }
+    }
+
+    if ( count != size )
+        d_data->points.resize(count);
+
+    // split the upper levels, until there are enough subtrees
+    // for all threads
+
+    const int numThreads = QwtParallel::chunkCount(count, qwtMinChunkSize);
+
+    QwtArray<PrivateData::Range> ranges;
+
+    const PrivateData::Range root = { 0, count, 0 };
+    ranges += root;
+
+    while ( ranges.size() < numThreads )
+    {
+        QwtArray<PrivateData::Range> subRanges;
+
+        for ( int i = 0; i < int(ranges.size()); i++ )
+        {
+            const PrivateData::Range &r = ranges[i];
+            if ( r.to - r.from <= qwtLeafSize )
+            {
+                subRanges += r;
+                continue;
+            }
+
+            const int mid = d_data->split(r);
+
+            const PrivateData::Range r1 = { r.from, mid, 1 - r.axis };
+            const PrivateData::Range r2 = { mid + 1, r.to, 1 - r.axis };
+
+            subRanges += r1;
+            subRanges += r2;
+        }
+
+        if ( subRanges.size() == ranges.size() )
+            break;
+
+        ranges = subRanges;
+    }
+
+    const PrivateData::Range *r = ranges.data();
+    QwtParallel::run(ranges.size(), [this, r](int i)
+    {
+        d_data->build(r[i]);
+    });
+}
+
+//! Remove all points from the index
+void QwtSpatialIndex::reset()
+{
+    d_data->points.clear();
+}
+
+//! \return Number of indexed points
+size_t QwtSpatialIndex::size() const
+{
+    return d_data->points.size();
+}
+
+/*!
+  \brief Find the point, that is closest to a position
+
+  The distance is measured in paint device coordinates, what is
+  the same as in QwtPlotCurve::closestPoint().
+
+  \param xMap Maps x values into paint device coordinates
+  \param yMap Maps y values into paint device coordinates
+  \param pos Position in paint device coordinates
+  \param dist If dist != nullptr, closestPoint() returns the distance
+              between the position and the closest point.
+
+  \return Index of the closest point, or -1 if the index is empty
+          or all points are more than 1e5 pixels away.
+*/
+int QwtSpatialIndex::closestPoint(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtDoublePoint &pos, double *dist) const
+{
+    PrivateData::Query query;
+    PrivateData::initQuery(query, xMap, yMap, pos);
+
+    if ( !d_data->points.isEmpty() )
+    {
+        const PrivateData::Range root = { 0, int(d_data->points.size()), 0 };
+        d_data->closestPoint(root, query);
+    }
+
+    if ( dist )
+        *dist = ::sqrt(query.dist);
+
+    return query.index;
+}
+
+/*!
+  \brief Find the points inside of a rectangle
+
+  \param rect Rectangle in data coordinates, including its borders
+  \return Ascending indices of the points inside of rect
+*/
+QwtArray<int> QwtSpatialIndex::pointsInside(const QwtDoubleRect &rect) const
+{
+    return d_data->pointsInside(nullptr, nullptr, rect, nullptr);
+}
+
+/*!
+  \brief Find the points inside of a polygon
+
+  \param polygon Polygon in data coordinates, using the odd-even rule
+  \return Ascending indices of the points inside of polygon
+*/
+QwtArray<int> QwtSpatialIndex::pointsInside(const QwtPolygonF &polygon) const
+{
+    return d_data->pointsInside(nullptr, nullptr,
+        polygon.boundingRect(), &polygon);
+}
+
+/*!
+  \brief Find the points inside of a rectangle
+
+  \param xMap Maps x values into paint device coordinates
+  \param yMap Maps y values into paint device coordinates
+  \param rect Rectangle in paint device coordinates, including its borders
+
+  \return Ascending indices of the points inside of rect
+*/
+QwtArray<int> QwtSpatialIndex::pointsInside(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtDoubleRect &rect) const
+{
+    return d_data->pointsInside(&xMap, &yMap, rect, nullptr);
+}
+
+/*!
+  \brief Find the points inside of a polygon
+
+  \param xMap Maps x values into paint device coordinates
+  \param yMap Maps y values into paint device coordinates
+  \param polygon Polygon in paint device coordinates,
+                 using the odd-even rule
+
+  \return Ascending indices of the points inside of polygon
+*/
+QwtArray<int> QwtSpatialIndex::pointsInside(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtPolygonF &polygon) const
+{
+    return d_data->pointsInside(&xMap, &yMap,
+        polygon.boundingRect(), &polygon);
+}
+
+/*!
+  \brief Find the point of a series, that is closest to a position
+
+  Without an index all points are iterated, what takes O(n).
+  The result is the same as for an index built for data.
+
+  \param data Series of points
+  \param xMap Maps x values into paint device coordinates
+  \param yMap Maps y values into paint device coordinates
+  \param pos Position in paint device coordinates
+  \param dist If dist != nullptr, closestPoint() returns the distance
+              between the position and the closest point.
+
+  \return Index of the closest point, or -1 if the series is empty
+          or all points are more than 1e5 pixels away.
+*/
+int QwtSpatialIndex::closestPoint(const QwtData &data,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtDoublePoint &pos, double *dist)
+{
+    PrivateData::Query query;
+    PrivateData::initQuery(query, xMap, yMap, pos);
+
+    PrivateData::scan(data, query);
+
+    if ( dist )
+        *dist = ::sqrt(query.dist);
+
+    return query.index;
+}
+
+/*!
+  \brief Find the points of a series inside of a rectangle,
+         without an index
+
+  \param data Series of points
+  \param rect Rectangle in data coordinates, including its borders
+  \return Ascending indices of the points inside of rect
+*/
+QwtArray<int> QwtSpatialIndex::pointsInside(const QwtData &data,
+    const QwtDoubleRect &rect)
+{
+    return PrivateData::scan(data, nullptr, nullptr, rect, nullptr);
+}
+
+/*!
+  \brief Find the points of a series inside of a polygon,
+         without an index
+
+  \param data Series of points
+  \param polygon Polygon in data coordinates, using the odd-even rule
+  \return Ascending indices of the points inside of polygon
+*/
+QwtArray<int> QwtSpatialIndex::pointsInside(const QwtData &data,
+    const QwtPolygonF &polygon)
+{
+    return PrivateData::scan(data, nullptr, nullptr,
+        polygon.boundingRect(), &polygon);
+}
+
+/*!
+  \brief Find the points of a series inside of a rectangle,
+         without an index
+
+  \param data Series of points
+  \param xMap Maps x values into paint device coordinates
+  \param yMap Maps y values into paint device coordinates
+  \param rect Rectangle in paint device coordinates, including its borders
+
+  \return Ascending indices of the points inside of rect
+*/
+QwtArray<int> QwtSpatialIndex::pointsInside(const QwtData &data,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtDoubleRect &rect)
+{
+    return PrivateData::scan(data, &xMap, &yMap, rect, nullptr);
+}
+
+/*!
+  \brief Find the points of a series inside of a polygon,
+         without an index
+
+  \param data Series of points
+  \param xMap Maps x values into paint device coordinates
+  \param yMap Maps y values into paint device coordinates
+  \param polygon Polygon in paint device coordinates,
+                 using the odd-even rule
+
+  \return Ascending indices of the points inside of polygon
+*/
+QwtArray<int> QwtSpatialIndex::pointsInside(const QwtData &data,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtPolygonF &polygon)
+{
+    return PrivateData::scan(data, &xMap, &yMap,
+        polygon.boundingRect(), &polygon);
+}
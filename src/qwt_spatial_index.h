@@ -0,0 +1,91 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_SPATIAL_INDEX_H
+#define QWT_SPATIAL_INDEX_H 1
+
+#include "qwt_global.h"
+#include "qwt_array.h"
+#include "qwt_double_rect.h"
+#include "qwt_polygon.h"
+
+class QwtData;
+class QwtScaleMap;
+
+/*!
+  \brief A k-d tree of the points of a series
+
+  QwtSpatialIndex sorts the points of a series into a balanced 2-d tree,
+  that is built in O(n * log(n)) and answers nearest neighbour queries
+  in O(log(n)) on average.
+
+  The tree is organized in data coordinates, so it doesn't need to be
+  rebuilt, when the scales are changed. As the transformations of the
+  scale maps are monotonic, distances can be measured in paint device
+  coordinates, what makes the queries independent of the
+  aspect ratio of the scales.
+
+  Region queries return the points inside of a rectangle or polygon,
+  given in data or paint device coordinates. Only the subtrees, that
+  intersect with the bounding rectangle of the region, are visited.
+
+  The index copies the coordinates of the points. It has to be
+  rebuilt with setData(), when the data has been modified.
+  For data, that is modified frequently, the static queries find
+  the same points by iterating over the data without an index.
+
+  \sa QwtPlotCurve::closestPoint(), QwtPlotCurve::pointsInside()
+*/
+class QWT_EXPORT QwtSpatialIndex
+{
+public:
+    QwtSpatialIndex();
+    ~QwtSpatialIndex();
+
+    void setData(const QwtData &);
+    void reset();
+
+    size_t size() const;
+
+    int closestPoint(const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QwtDoublePoint &pos, double *dist = nullptr) const;
+
+    QwtArray<int> pointsInside(const QwtDoubleRect &) const;
+    QwtArray<int> pointsInside(const QwtPolygonF &) const;
+
+    QwtArray<int> pointsInside(const QwtScaleMap &xMap,
+        const QwtScaleMap &yMap, const QwtDoubleRect &) const;
+    QwtArray<int> pointsInside(const QwtScaleMap &xMap,
+        const QwtScaleMap &yMap, const QwtPolygonF &) const;
+
+    static int closestPoint(const QwtData &,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QwtDoublePoint &pos, double *dist = nullptr);
+
+    static QwtArray<int> pointsInside(const QwtData &,
+        const QwtDoubleRect &);
+    static QwtArray<int> pointsInside(const QwtData &,
+        const QwtPolygonF &);
+
+    static QwtArray<int> pointsInside(const QwtData &,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QwtDoubleRect &);
+    static QwtArray<int> pointsInside(const QwtData &,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QwtPolygonF &);
+
+private:
+    QwtSpatialIndex(const QwtSpatialIndex &);
+    QwtSpatialIndex &operator=(const QwtSpatialIndex &);
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+#endif
@@ -8,7 +8,9 @@
  *****************************************************************************/
 
 #include <qpainter.h>
+#include <qpaintengine.h>
 #include <qapplication.h>
+#include "qwt_math.h"
 #include "qwt_painter.h"
 #include "qwt_polygon.h"
 #include "qwt_symbol.h"
@@ -23,7 +25,9 @@ QwtSymbol::QwtSymbol():
     d_brush(Qt::gray), 
     d_pen(Qt::black), 
     d_size(0,0),
-    d_style(QwtSymbol::NoSymbol)
+    d_style(QwtSymbol::NoSymbol),
+    d_cachePolicy(QwtSymbol::AutoCache),
+    d_spriteAntialiased(false)
 {
 }
 
@@ -39,7 +43,25 @@ QwtSymbol::QwtSymbol(QwtSymbol::Style style, const QBrush &brush,
     d_brush(brush), 
     d_pen(pen), 
     d_size(size),
-    d_style(style)
+    d_style(style),
+    d_cachePolicy(QwtSymbol::AutoCache),
+    d_spriteAntialiased(false)
+{
+}
+
+/*!
+  \brief Copy constructor
+
+  The sprite of drawSymbols() is not copied.
+  \param other Symbol
+*/
+QwtSymbol::QwtSymbol(const QwtSymbol &other):
+    d_brush(other.d_brush),
+    d_pen(other.d_pen),
+    d_size(other.d_size),
+    d_style(other.d_style),
+    d_cachePolicy(other.d_cachePolicy),
+    d_spriteAntialiased(false)
 {
 }
 
@@ -48,6 +70,28 @@ QwtSymbol::~QwtSymbol()
 {
 }
 
+/*!
+  \brief Assignment operator
+
+  The sprite of drawSymbols() is invalidated.
+  \param other Symbol
+*/
+QwtSymbol &QwtSymbol::operator=(const QwtSymbol &other)
+{
+    if ( this != &other )
+    {
+        d_brush = other.d_brush;
+        d_pen = other.d_pen;
+        d_size = other.d_size;
+        d_style = other.d_style;
+        d_cachePolicy = other.d_cachePolicy;
+
+        invalidateCache();
+    }
+
+    return *this;
+}
+
 /*!
   Allocate and return a symbol with the same attributes
   \return Cloned symbol
@@ -74,6 +118,8 @@ void QwtSymbol::setSize(int width, int height)
     if ((width >= 0) && (height < 0)) 
         height = width;
     d_size = QSize(width, height);
+
+    invalidateCache();
 }
 
 /*! 
@@ -83,7 +129,10 @@ void QwtSymbol::setSize(int width, int height)
 void QwtSymbol::setSize(const QSize &size)
 {
     if (size.isValid()) 
+    {
         d_size = size;
+        invalidateCache();
+    }
 }
 
 /*!
@@ -95,6 +144,7 @@ void QwtSymbol::setSize(const QSize &size)
 void QwtSymbol::setBrush(const QBrush &brush)
 {
     d_brush = brush;
+    invalidateCache();
 }
 
 /*!
@@ -111,6 +161,7 @@ void QwtSymbol::setBrush(const QBrush &brush)
 void QwtSymbol::setPen(const QPen &pen)
 {
     d_pen = pen;
+    invalidateCache();
 }
 
 /*!
@@ -348,6 +399,196 @@ void QwtSymbol::draw(QPainter *painter, const QPoint &pos) const
 void QwtSymbol::setStyle(QwtSymbol::Style s)
 {
     d_style = s;
+    invalidateCache();
+}
+
+/*!
+  Change the cache policy
+
+  \param policy Cache policy
+  \sa CachePolicy, cachePolicy(), drawSymbols()
+*/
+void QwtSymbol::setCachePolicy(QwtSymbol::CachePolicy policy)
+{
+    if ( policy != d_cachePolicy )
+    {
+        d_cachePolicy = policy;
+        invalidateCache();
+    }
+}
+
+/*!
+  \return Cache policy
+  \sa CachePolicy, setCachePolicy()
+*/
+QwtSymbol::CachePolicy QwtSymbol::cachePolicy() const
+{
+    return d_cachePolicy;
+}
+
+/*!
+  \brief Invalidate the sprite of drawSymbols()
+
+  The attributes of QwtSymbol invalidate the sprite, when they are
+  changed. Derived classes with additional attributes, that have an
+  effect on draw(), need to call invalidateCache(), when they are
+  modified.
+*/
+void QwtSymbol::invalidateCache()
+{
+    QMutexLocker locker(&d_spriteMutex);
+    d_sprite = QImage();
+}
+
+static bool qwtUseSprite(const QPainter *painter,
+    QwtSymbol::CachePolicy policy)
+{
+    switch(policy)
+    {
+        case QwtSymbol::NoCache:
+            return false;
+        case QwtSymbol::Cache:
+            return true;
+        default:
+        {
+            if ( !QwtPainter::metricsMap().isIdentity() )
+                return false;
+
+            if ( painter->transform().type() > QTransform::TxTranslate )
+                return false;
+
+            const QPaintEngine *pe = painter->paintEngine();
+            return pe && pe->type() == QPaintEngine::Raster;
+        }
+    }
+}
+
+/*!
+  \brief Draw the symbol at many positions
+
+  Depending on the cache policy, the symbol is rendered once into
+  a sprite, that is copied to all positions. As the positions are
+  rounded to device pixels, the result is the same as painting each
+  symbol with draw().
+
+  Contrary to draw(painter, rect) the painter doesn't need to be
+  initialized with pen and brush of the symbol.
+
+  \param painter Painter
+  \param points Centers of the symbols
+  \param numPoints Number of points
+
+  \sa setCachePolicy(), draw()
+*/
+void QwtSymbol::drawSymbols(QPainter *painter,
+    const QPointF *points, int numPoints) const
+{
+    if ( numPoints <= 0 || d_style == QwtSymbol::NoSymbol )
+        return;
+
+    QRect rect;
+    rect.setSize(QwtPainter::metricsMap().screenToLayout(d_size));
+
+    if ( d_style == QwtSymbol::Rect && rect.width() == 1 &&
+        rect.height() == 1 && d_pen.style() == Qt::NoPen &&
+        d_brush.style() == Qt::SolidPattern )
+    {
+        // a one-pixel symbol is a dot in the color of the brush
+
+        painter->setPen(QPen(d_brush.color(), 0));
+        QwtPainter::drawPoints(painter, points, numPoints);
+
+        return;
+    }
+
+    const QPen pen = QwtPainter::scaledPen(d_pen);
+
+    if ( qwtUseSprite(painter, d_cachePolicy) )
+    {
+        const QImage image = sprite(painter, rect.size(), pen);
+
+        const qreal ratio = image.devicePixelRatio();
+        const int dx = (qRound(image.width() / ratio) - rect.width()) / 2;
+        const int dy = (qRound(image.height() / ratio) - rect.height()) / 2;
+
+        for ( int i = 0; i < numPoints; i++ )
+        {
+            rect.moveCenter(QPoint(qRound(points[i].x()),
+                qRound(points[i].y())));
+
+            painter->drawImage(rect.x() - dx, rect.y() - dy, image);
+        }
+    }
+    else
+    {
+        painter->setBrush(d_brush);
+        painter->setPen(pen);
+
+        for ( int i = 0; i < numPoints; i++ )
+        {
+            rect.moveCenter(QPoint(qRound(points[i].x()),
+                qRound(points[i].y())));
+
+            draw(painter, rect);
+        }
+    }
+}
+
+/*
+  The sprite is rendered for a specific size of the symbol,
+  the pen scaled to the paint device and the render hints
+  and device pixel ratio of the painter.
+
+  drawSymbols() might be called from several threads at the same time,
+  f.e. when the items of a plot are rendered in parallel. So the sprite
+  is an image, that can be used in any thread, and is guarded by a mutex.
+  The returned copy is shared implicitly.
+ */
+QImage QwtSymbol::sprite(QPainter *painter,
+    const QSize &size, const QPen &pen) const
+{
+    const bool antialiased =
+        painter->testRenderHint(QPainter::Antialiasing);
+
+    qreal ratio = 1.0;
+#if QT_VERSION >= 0x050600
+    if ( painter->device() )
+        ratio = painter->device()->devicePixelRatioF();
+#endif
+
+    QMutexLocker locker(&d_spriteMutex);
+
+    if ( !d_sprite.isNull() && size == d_spriteSize && pen == d_spritePen
+        && antialiased == d_spriteAntialiased
+        && ratio == d_sprite.devicePixelRatio() )
+    {
+        return d_sprite;
+    }
+
+    // the outline might exceed the rectangle of the symbol
+    const int margin = int(::ceil(0.5 * qwtMax(pen.widthF(), 1.0))) + 1;
+
+    const QSize spriteSize(size.width() + 2 * margin,
+        size.height() + 2 * margin);
+
+    QImage image(spriteSize * ratio, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(ratio);
+    image.fill(Qt::transparent);
+
+    QPainter spritePainter(&image);
+    spritePainter.setRenderHint(QPainter::Antialiasing, antialiased);
+    spritePainter.setBrush(d_brush);
+    spritePainter.setPen(pen);
+
+    draw(&spritePainter, QRect(QPoint(margin, margin), size));
+    spritePainter.end();
+
+    d_sprite = image;
+    d_spriteSize = size;
+    d_spritePen = pen;
+    d_spriteAntialiased = antialiased;
+
+    return d_sprite;
 }
 
 //! == operator
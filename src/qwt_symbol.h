@@ -13,10 +13,13 @@
 #include <qbrush.h>
 #include <qpen.h>
 #include <qsize.h>
+#include <qimage.h>
+#include <qmutex.h>
 #include "qwt_global.h"
 
 class QPainter;
 class QRect;
+class QPointF;
 
 //! A class for drawing symbols
 class QWT_EXPORT QwtSymbol
@@ -49,11 +52,39 @@ public:
 
         StyleCnt 
     };
+
+    /*!
+      Cache policy for drawSymbols()
+
+      - NoCache\n
+        Each symbol is painted using draw().
+      - Cache\n
+        The symbol is rendered once into an image ( sprite ), that
+        is copied to the positions of all symbols. As the sprite
+        is an image, that is guarded by a mutex, symbols can be
+        painted from any thread.
+      - AutoCache\n
+        The sprite is used, when painting to a raster device
+        without any scaling or rotation. Otherwise the symbols
+        are painted like for NoCache.
+
+      The default setting is AutoCache
+      \sa setCachePolicy(), cachePolicy(), drawSymbols()
+     */
+    enum CachePolicy
+    {
+        NoCache,
+        Cache,
+        AutoCache
+    };
    
 public:
     QwtSymbol();
     QwtSymbol(Style st, const QBrush &bd, const QPen &pn, const QSize &s);
+    QwtSymbol(const QwtSymbol &);
     virtual ~QwtSymbol();
+
+    QwtSymbol &operator=(const QwtSymbol &);
     
     bool operator!=(const QwtSymbol &) const;
     virtual bool operator==(const QwtSymbol &) const;
@@ -74,16 +105,33 @@ public:
     const QSize& size() const { return d_size; }
     //! Return Style
     Style style() const { return d_style; } 
+
+    void setCachePolicy(CachePolicy);
+    CachePolicy cachePolicy() const;
+
+    void invalidateCache();
     
     void draw(QPainter *p, const QPoint &pt) const; 
     void draw(QPainter *p, int x, int y) const;
     virtual void draw(QPainter *p, const QRect &r) const;
 
+    void drawSymbols(QPainter *, const QPointF *points, int numPoints) const;
+
 private:
+    QImage sprite(QPainter *, const QSize &, const QPen &) const;
+
     QBrush d_brush;
     QPen d_pen;
     QSize d_size;
     Style d_style;
+
+    CachePolicy d_cachePolicy;
+
+    mutable QMutex d_spriteMutex;
+    mutable QImage d_sprite;
+    mutable QSize d_spriteSize;
+    mutable QPen d_spritePen;
+    mutable bool d_spriteAntialiased;
 };
 
 #endif
@@ -13,6 +13,7 @@
 #include <qpixmap.h>
 #include <qimage.h>
 #include <qmap.h>
+#include <qmutex.h>
 #include <qwidget.h>
 #include "qwt_math.h"
 #include "qwt_painter.h"
@@ -87,6 +88,9 @@ public:
     {
         const QString fontKey = font.key();
 
+        // the engine is shared by texts painted in different threads
+        QMutexLocker locker(&d_mutex);
+
         QMap<QString, int>::const_iterator it = 
             d_ascentCache.find(fontKey);
         if ( it == d_ascentCache.end() )
@@ -105,26 +109,27 @@ private:
         static const QColor white(Qt::white);
 
         const QFontMetrics fm(font);
+
+        // unlike pixmaps images can be used outside of the GUI thread
 #if QT_VERSION < 0x050f00
-        QPixmap pm(fm.width(dummy), fm.height());
+        QImage img(fm.width(dummy), fm.height(), QImage::Format_RGB32);
 #else
-        QPixmap pm(fm.horizontalAdvance(dummy), fm.height());
+        QImage img(fm.horizontalAdvance(dummy), fm.height(),
+            QImage::Format_RGB32);
 #endif
-        pm.fill(white);
+        img.fill(white);
 
-        QPainter p(&pm);
+        QPainter p(&img);
         p.setFont(font);  
-        p.drawText(0, 0,  pm.width(), pm.height(), 0, dummy);
+        p.drawText(0, 0,  img.width(), img.height(), 0, dummy);
         p.end();
 
-        const QImage img = pm.toImage();
-
         int row = 0;
         for ( row = 0; row < img.height(); row++ )
         {   
             const QRgb *line = (const QRgb *)img.scanLine(row);
 
-            const int w = pm.width();
+            const int w = img.width();
             for ( int col = 0; col < w; col++ )
             {   
                 if ( line[col] != white.rgb() )
@@ -136,6 +141,7 @@ private:
     }   
 
     mutable QMap<QString, int> d_ascentCache;
+    mutable QMutex d_mutex;
 };
 
 //! Constructor